@@ -0,0 +1,27 @@
+/// draw_line.cpp
+/// Provides the C functions of draw_line.h, as instantiations of the templates in draw_line.hpp.
+
+#include "draw_line.h"
+#include "draw_line.hpp"
+
+extern "C" void drawline_inside_rect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width,
+    uint32_t color, uint32_t *pixels, int width, int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x,
+    int32_t rect_max_y, bool include_endpoints)
+{
+    draw_line::draw_inside_rect<uint32_t, draw_line::Overwrite>(x1, y1, x2, y2, pixel_width, color, pixels, width,
+        rect_min_x, rect_min_y, rect_max_x, rect_max_y, include_endpoints);
+}
+
+extern "C" void drawline_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width,
+    uint32_t color, uint32_t *pixels, int width, int height)
+{
+    draw_line::draw_include_endpoints<uint32_t, draw_line::Overwrite>(x1, y1, x2, y2, pixel_width, color, pixels,
+        width, height);
+}
+
+extern "C" void drawline_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width,
+    uint32_t color, uint32_t *pixels, int width, int height)
+{
+    draw_line::draw_exclude_endpoints<uint32_t, draw_line::Overwrite>(x1, y1, x2, y2, pixel_width, color, pixels,
+        width, height);
+}
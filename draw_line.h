@@ -3,6 +3,11 @@
 #define DRAW_LINE_H
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 void drawline_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width, uint32_t color,
     uint32_t *pixels, int width, int height);
@@ -10,4 +15,15 @@ void drawline_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
 void drawline_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width, uint32_t color,
     uint32_t *pixels, int width, int height);
 
+/// Draws the pixels of a line that are inside of a rectangle of the image.
+/// The pixels drawn are exactly the pixels of drawline_include_endpoints() (or drawline_exclude_endpoints() if
+/// include_endpoints is false) that are inside the inclusive rectangle, which must be inside of the image.
+void drawline_inside_rect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width, uint32_t color,
+    uint32_t *pixels, int width, int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y,
+    bool include_endpoints);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // DRAW_LINE_H
@@ -0,0 +1,268 @@
+/// draw_line.hpp
+/// Provides header-only C++ templates for drawing lines into images of any pixel type with any blend operation.
+/// The blend operation is a template parameter, so it is inlined into the loops over the runs of pixels.
+
+#ifndef DRAW_LINE_HPP
+#define DRAW_LINE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include "line_traverser.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace draw_line
+{
+
+/// Blend operation which replaces pixels with the color, like drawline_include_endpoints().
+struct Overwrite
+{
+    template <typename Pixel>
+    Pixel operator()(Pixel pixel, Pixel color) const
+    {
+        (void)pixel;
+        return color;
+    }
+};
+
+/// Blend operation which adds the color to pixels. Integer pixels saturate instead of overflowing.
+struct Add
+{
+    template <typename Pixel>
+    Pixel operator()(Pixel pixel, Pixel color) const
+    {
+        if constexpr (std::is_integral<Pixel>::value)
+        {
+            Pixel sum;
+            if (__builtin_add_overflow(pixel, color, &sum))
+                return (color > 0) ? (std::numeric_limits<Pixel>::max)() : (std::numeric_limits<Pixel>::min)();
+            return sum;
+        }
+        else
+        {
+            return pixel + color;
+        }
+    }
+};
+
+/// Blend operation which keeps the greater of the pixel and the color.
+struct Max
+{
+    template <typename Pixel>
+    Pixel operator()(Pixel pixel, Pixel color) const
+    {
+        return (pixel < color) ? color : pixel;
+    }
+};
+
+/// Blend operation which draws a 32 bit color with 8 bits per channel over pixels, with the opacity of the color
+/// in its highest 8 bits. An opaque color replaces the pixel, and a transparent color leaves it unchanged.
+/// The opacity of the pixel is composited like the other channels, but towards fully opaque, so drawing only ever
+/// makes a pixel more opaque: 0xFF000000 drawn over with 0x80808080 gives 0xFF404040.
+struct AlphaBlend
+{
+    uint32_t operator()(uint32_t pixel, uint32_t color) const
+    {
+        // 0 to 256 rather than 255, so the channels can be divided by 256 with a shift.
+        uint32_t alpha = (color >> 24) + (color >> 31);
+        uint32_t inverse_alpha = 256 - alpha;
+        // Two channels are blended at once, each in 16 bits which the products never overflow.
+        // The opacity channel is blended towards fully opaque.
+        uint32_t red_blue = (((color & 0x00FF00FF) * alpha + (pixel & 0x00FF00FF) * inverse_alpha) >> 8) & 0x00FF00FF;
+        uint32_t green_alpha = ((((color | 0xFF000000) >> 8) & 0x00FF00FF) * alpha +
+            ((pixel >> 8) & 0x00FF00FF) * inverse_alpha) & 0xFF00FF00;
+        return red_blue | green_alpha;
+    }
+};
+
+/// Blend operation which moves floating point pixels towards the color by a fraction.
+struct Lerp
+{
+    float alpha;
+
+    template <typename Pixel>
+    Pixel operator()(Pixel pixel, Pixel color) const
+    {
+        return pixel + (color - pixel) * alpha;
+    }
+};
+
+/// Blends as much of a row of pixels as the SIMD kernels can.
+/// @returns the number of pixels blended from the start of the row.
+/// @remarks When compiled with AVX2 (-mavx2), saturating adds and maxima of 8 and 16 bit pixels are blended
+/// 32 bytes at a time. Other blends are left to the scalar loop, which compilers can vectorize themselves.
+template <typename Pixel, typename Blend>
+inline int32_t blend_row_simd(Pixel *row, int32_t count, Pixel color)
+{
+#if defined(__AVX2__)
+    constexpr bool is_add = std::is_same<Blend, Add>::value;
+    constexpr bool is_max = std::is_same<Blend, Max>::value;
+    if constexpr (std::is_unsigned<Pixel>::value && (sizeof(Pixel) == 1 || sizeof(Pixel) == 2) && (is_add || is_max))
+    {
+        constexpr int32_t lane_count = 32 / sizeof(Pixel);
+        __m256i colors = (sizeof(Pixel) == 1) ? _mm256_set1_epi8((char)color) : _mm256_set1_epi16((short)color);
+        int32_t i = 0;
+        for (; i + lane_count <= count; i += lane_count)
+        {
+            __m256i pixels = _mm256_loadu_si256((const __m256i*)(row + i));
+            if constexpr (sizeof(Pixel) == 1)
+                pixels = is_add ? _mm256_adds_epu8(pixels, colors) : _mm256_max_epu8(pixels, colors);
+            else
+                pixels = is_add ? _mm256_adds_epu16(pixels, colors) : _mm256_max_epu16(pixels, colors);
+            _mm256_storeu_si256((__m256i*)(row + i), pixels);
+        }
+        return i;
+    }
+#endif
+    (void)row;
+    (void)count;
+    (void)color;
+    return 0;
+}
+
+/// Blends a run of pixels which are step pixels apart in memory.
+/// @param pixel is a pointer to the first pixel of the run.
+/// @param step is the distance between pixels of the run. It is 1 for a row, and the image width for a column.
+/// @param count is the number of pixels in the run.
+/// @param color is the color to blend.
+/// @param blend is the blend operation, called as blend(pixel, color) to get the new pixel.
+template <typename Pixel, typename Blend>
+inline void blend_run(Pixel *pixel, ptrdiff_t step, int32_t count, Pixel color, const Blend &blend)
+{
+    if (step == 1)
+    {
+        if constexpr (std::is_same<Blend, Overwrite>::value)
+        {
+            std::fill_n(pixel, count, color);
+            return;
+        }
+        int32_t blended = blend_row_simd<Pixel, Blend>(pixel, count, color);
+        for (int32_t i = blended; i < count; i++)
+            pixel[i] = blend(pixel[i], color);
+        return;
+    }
+    for (int32_t i = 0; i < count; i++, pixel += step)
+        *pixel = blend(*pixel, color);
+}
+
+/// Draws the pixels of a line that are inside of a rectangle of an image.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param pixel_width is the width of a pixel, in the coordinates of the line.
+/// @param color is the color to blend into the pixels.
+/// @param pixels is the row-major image.
+/// @param width is the number of pixels in a row of the image.
+/// @param rect_min_x is the inclusive minimum x of the rectangle, which must be inside of the image.
+/// @param rect_min_y is the inclusive minimum y of the rectangle.
+/// @param rect_max_x is the inclusive maximum x of the rectangle.
+/// @param rect_max_y is the inclusive maximum y of the rectangle.
+/// @param include_endpoints is true to draw the pixels of the starting and ending points.
+/// @param blend is the blend operation, called as blend(pixel, color) to get the new pixel.
+/// @remarks Every pixel is blended once. drawline_inside_rect() is the <uint32_t, Overwrite> instantiation.
+template <typename Pixel, typename Blend = Overwrite>
+inline void draw_inside_rect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width, Pixel color,
+    Pixel *pixels, int width, int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y,
+    bool include_endpoints, const Blend &blend = Blend())
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, pixel_width);
+    // The end grid square of a line with negative coordinates may not be on its steps, which would then go past the
+    // rectangle.
+    if (x1 < 0 || y1 < 0 || x2 < 0 || y2 < 0)
+        LineTraverser_end_where_reached(&traverser, x1, y1, x2, y2, pixel_width);
+    int32_t start_x = traverser.x, start_y = traverser.y;
+    int32_t end_x = traverser.end_x, end_y = traverser.end_y;
+    if (!LineTraverser_clip_to_rect(&traverser, rect_min_x, rect_min_y, rect_max_x, rect_max_y))
+        return;
+    // Every pixel of the clipped traverser is inside the rectangle, so the spans are blended without bounds checks.
+    while (true)
+    {
+        int32_t span_x1, span_y1, span_x2, span_y2;
+        LineTraverser_get_point(&traverser, &span_x1, &span_y1);
+        LineTraverser_skip_span(&traverser);
+        LineTraverser_get_point(&traverser, &span_x2, &span_y2);
+        int32_t first_x = span_x1, first_y = span_y1;
+        int32_t count = std::abs(span_x2 - span_x1) + std::abs(span_y2 - span_y1) + 1;
+        if (!include_endpoints)
+        {
+            // The endpoints of the whole line can only be at the ends of a span.
+            if (span_x1 == start_x && span_y1 == start_y)
+            {
+                first_x += (span_x2 > span_x1) - (span_x2 < span_x1);
+                first_y += (span_y2 > span_y1) - (span_y2 < span_y1);
+                count--;
+            }
+            if (span_x2 == end_x && span_y2 == end_y)
+                count--;
+        }
+        // Spans are blended from their lower end, so rows are always contiguous runs.
+        if (span_y1 == span_y2)
+        {
+            int32_t last_x = first_x + ((span_x2 >= span_x1) ? 1 : -1) * (count - 1);
+            if (count > 0)
+                blend_run(pixels + (ptrdiff_t)first_y * width + ((first_x < last_x) ? first_x : last_x), 1, count,
+                    color, blend);
+        }
+        else
+        {
+            int32_t last_y = first_y + ((span_y2 >= span_y1) ? 1 : -1) * (count - 1);
+            if (count > 0)
+                blend_run(pixels + (ptrdiff_t)((first_y < last_y) ? first_y : last_y) * width + first_x, width, count,
+                    color, blend);
+        }
+        if (LineTraverser_is_end(&traverser))
+            break;
+        LineTraverser_next(&traverser);
+    }
+}
+
+/// Draws a line into an image, including the pixels of the starting and ending points.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param pixel_width is the width of a pixel, in the coordinates of the line.
+/// @param color is the color to blend into the pixels.
+/// @param pixels is the row-major image.
+/// @param width is the number of pixels in a row of the image.
+/// @param height is the number of rows in the image.
+/// @param blend is the blend operation, called as blend(pixel, color) to get the new pixel.
+/// @remarks drawline_include_endpoints() is the <uint32_t, Overwrite> instantiation.
+template <typename Pixel, typename Blend = Overwrite>
+inline void draw_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width, Pixel color,
+    Pixel *pixels, int width, int height, const Blend &blend = Blend())
+{
+    if (width <= 0 || height <= 0)
+        return;
+    draw_inside_rect(x1, y1, x2, y2, pixel_width, color, pixels, width, 0, 0, width - 1, height - 1, true, blend);
+}
+
+/// Draws a line into an image, excluding the pixels of the starting and ending points.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param pixel_width is the width of a pixel, in the coordinates of the line.
+/// @param color is the color to blend into the pixels.
+/// @param pixels is the row-major image.
+/// @param width is the number of pixels in a row of the image.
+/// @param height is the number of rows in the image.
+/// @param blend is the blend operation, called as blend(pixel, color) to get the new pixel.
+/// @remarks drawline_exclude_endpoints() is the <uint32_t, Overwrite> instantiation.
+template <typename Pixel, typename Blend = Overwrite>
+inline void draw_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t pixel_width, Pixel color,
+    Pixel *pixels, int width, int height, const Blend &blend = Blend())
+{
+    if (width <= 0 || height <= 0)
+        return;
+    draw_inside_rect(x1, y1, x2, y2, pixel_width, color, pixels, width, 0, 0, width - 1, height - 1, false, blend);
+}
+
+} // namespace draw_line
+
+#endif // DRAW_LINE_HPP
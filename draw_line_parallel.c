@@ -0,0 +1,194 @@
+
+#include "draw_line_parallel.h"
+#include "draw_line.h"
+#include "line_traverser.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+typedef struct
+{
+    const int32_t *x1, *y1, *x2, *y2;
+    const uint32_t *colors;
+    int32_t line_count;
+    int32_t pixel_width;
+    uint32_t *pixels;
+    int width, height;
+    bool include_endpoints;
+    int32_t tiles_x, tiles_y;
+    int32_t *tile_offsets;
+    int32_t *tile_lines;
+    pthread_mutex_t mutex;
+    int32_t next_tile;
+} DrawLineParallelJob;
+
+/// Calls visit_tile() for every tile a line may draw to.
+void draw_line_parallel_bin_line(DrawLineParallelJob *p_job, int32_t line,
+    void (*visit_tile)(DrawLineParallelJob *p_job, int32_t tile, int32_t line))
+{
+    int32_t x1 = p_job->x1[line], y1 = p_job->y1[line], x2 = p_job->x2[line], y2 = p_job->y2[line];
+    // Like drawline, lines with negative coordinates end where their steps reach.
+    bool negative = x1 < 0 || y1 < 0 || x2 < 0 || y2 < 0;
+    int64_t tile_width = (int64_t)p_job->pixel_width * DRAW_LINE_PARALLEL_TILE_SIZE;
+    if (tile_width <= INT32_MAX)
+    {
+        // A line over squares as wide as tiles traverses exactly the tiles of its pixels.
+        LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, (int32_t)tile_width);
+        if (negative)
+            LineTraverser_end_where_reached(&traverser, x1, y1, x2, y2, (int32_t)tile_width);
+        if (!LineTraverser_clip_to_rect(&traverser, 0, 0, p_job->tiles_x - 1, p_job->tiles_y - 1))
+            return;
+        while (true)
+        {
+            visit_tile(p_job, traverser.y * p_job->tiles_x + traverser.x, line);
+            if (LineTraverser_is_end(&traverser))
+                break;
+            LineTraverser_next(&traverser);
+        }
+        return;
+    }
+    // Tiles this wide don't fit in a traverser, so the pixels of the line inside the image are traversed instead.
+    // A line never comes back to a tile once it has left it, so every tile is visited once.
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, p_job->pixel_width);
+    if (negative)
+        LineTraverser_end_where_reached(&traverser, x1, y1, x2, y2, p_job->pixel_width);
+    if (!LineTraverser_clip_to_rect(&traverser, 0, 0, p_job->width - 1, p_job->height - 1))
+        return;
+    int32_t previous_tile = -1;
+    while (true)
+    {
+        int32_t tile = (traverser.y / DRAW_LINE_PARALLEL_TILE_SIZE) * p_job->tiles_x +
+            traverser.x / DRAW_LINE_PARALLEL_TILE_SIZE;
+        if (tile != previous_tile)
+            visit_tile(p_job, tile, line);
+        previous_tile = tile;
+        if (LineTraverser_is_end(&traverser))
+            break;
+        LineTraverser_next(&traverser);
+    }
+}
+
+void draw_line_parallel_count_tile(DrawLineParallelJob *p_job, int32_t tile, int32_t line)
+{
+    (void)line;
+    p_job->tile_offsets[tile + 1]++;
+}
+
+void draw_line_parallel_fill_tile(DrawLineParallelJob *p_job, int32_t tile, int32_t line)
+{
+    p_job->tile_lines[p_job->tile_offsets[tile]++] = line;
+}
+
+void *draw_line_parallel_worker(void *p_data)
+{
+    DrawLineParallelJob *p_job = (DrawLineParallelJob*)p_data;
+    while (true)
+    {
+        pthread_mutex_lock(&p_job->mutex);
+        int32_t tile = p_job->next_tile++;
+        pthread_mutex_unlock(&p_job->mutex);
+        if (tile >= p_job->tiles_x * p_job->tiles_y)
+            break;
+
+        int32_t tile_min_x = (tile % p_job->tiles_x) * DRAW_LINE_PARALLEL_TILE_SIZE;
+        int32_t tile_min_y = (tile / p_job->tiles_x) * DRAW_LINE_PARALLEL_TILE_SIZE;
+        int32_t tile_max_x = min(tile_min_x + DRAW_LINE_PARALLEL_TILE_SIZE, p_job->width) - 1;
+        int32_t tile_max_y = min(tile_min_y + DRAW_LINE_PARALLEL_TILE_SIZE, p_job->height) - 1;
+        // The lines of a tile are binned in order, so later lines overwrite earlier ones like drawing serially.
+        for (int32_t i = p_job->tile_offsets[tile]; i < p_job->tile_offsets[tile + 1]; i++)
+        {
+            int32_t line = p_job->tile_lines[i];
+            drawline_inside_rect(p_job->x1[line], p_job->y1[line], p_job->x2[line], p_job->y2[line],
+                p_job->pixel_width, p_job->colors[line], p_job->pixels, p_job->width,
+                tile_min_x, tile_min_y, tile_max_x, tile_max_y, p_job->include_endpoints);
+        }
+    }
+    return NULL;
+}
+
+bool draw_line_parallel_run(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    const uint32_t *colors, int32_t line_count, int32_t pixel_width, uint32_t *pixels, int width, int height,
+    int32_t thread_count, bool include_endpoints)
+{
+    if (line_count <= 0 || width <= 0 || height <= 0)
+        return true;
+    DrawLineParallelJob job;
+    job.x1 = x1;
+    job.y1 = y1;
+    job.x2 = x2;
+    job.y2 = y2;
+    job.colors = colors;
+    job.line_count = line_count;
+    job.pixel_width = pixel_width;
+    job.pixels = pixels;
+    job.width = width;
+    job.height = height;
+    job.include_endpoints = include_endpoints;
+    job.tiles_x = (width + DRAW_LINE_PARALLEL_TILE_SIZE - 1) / DRAW_LINE_PARALLEL_TILE_SIZE;
+    job.tiles_y = (height + DRAW_LINE_PARALLEL_TILE_SIZE - 1) / DRAW_LINE_PARALLEL_TILE_SIZE;
+    int32_t tile_count = job.tiles_x * job.tiles_y;
+
+    // Bin the lines into a compressed list per tile: count, prefix sum, then fill.
+    job.tile_offsets = (int32_t*)calloc(tile_count + 1, sizeof(int32_t));
+    if (!job.tile_offsets)
+        return false;
+    for (int32_t line = 0; line < line_count; line++)
+        draw_line_parallel_bin_line(&job, line, draw_line_parallel_count_tile);
+    for (int32_t tile = 0; tile < tile_count; tile++)
+        job.tile_offsets[tile + 1] += job.tile_offsets[tile];
+    job.tile_lines = (int32_t*)malloc(sizeof(int32_t) * max(job.tile_offsets[tile_count], 1));
+    if (!job.tile_lines)
+    {
+        free(job.tile_offsets);
+        return false;
+    }
+    for (int32_t line = 0; line < line_count; line++)
+        draw_line_parallel_bin_line(&job, line, draw_line_parallel_fill_tile);
+    // Filling moved every offset to the start of the next tile.
+    for (int32_t tile = tile_count; tile > 0; tile--)
+        job.tile_offsets[tile] = job.tile_offsets[tile - 1];
+    job.tile_offsets[0] = 0;
+
+    job.next_tile = 0;
+    pthread_mutex_init(&job.mutex, NULL);
+    // The calling thread is also a worker, so one less thread is started. If the threads can't be allocated,
+    // the calling thread draws every tile.
+    int32_t extra_thread_count = min(max(thread_count, 1), tile_count) - 1;
+    pthread_t *threads = (pthread_t*)malloc(sizeof(pthread_t) * max(extra_thread_count, 1));
+    int32_t started_count = 0;
+    for (int32_t i = 0; threads && i < extra_thread_count; i++)
+    {
+        if (pthread_create(&threads[started_count], NULL, draw_line_parallel_worker, &job) == 0)
+            started_count++;
+    }
+    draw_line_parallel_worker(&job);
+    for (int32_t i = 0; i < started_count; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&job.mutex);
+    free(job.tile_lines);
+    free(job.tile_offsets);
+    return true;
+}
+
+bool drawlines_parallel_include_endpoints(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    const uint32_t *colors, int32_t line_count, int32_t pixel_width, uint32_t *pixels, int width, int height,
+    int32_t thread_count)
+{
+    return draw_line_parallel_run(x1, y1, x2, y2, colors, line_count, pixel_width, pixels, width, height,
+        thread_count, true);
+}
+
+bool drawlines_parallel_exclude_endpoints(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    const uint32_t *colors, int32_t line_count, int32_t pixel_width, uint32_t *pixels, int width, int height,
+    int32_t thread_count)
+{
+    return draw_line_parallel_run(x1, y1, x2, y2, colors, line_count, pixel_width, pixels, width, height,
+        thread_count, false);
+}
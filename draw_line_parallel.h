@@ -0,0 +1,50 @@
+
+#ifndef DRAW_LINE_PARALLEL_H
+#define DRAW_LINE_PARALLEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// The width and height in pixels of the framebuffer tiles that lines are binned into.
+#define DRAW_LINE_PARALLEL_TILE_SIZE 64
+
+/// Draws many lines, splitting the image into tiles which are drawn by multiple threads.
+/// @param x1 is an array of the x coordinates of the starting points of the lines.
+/// @param y1 is an array of the y coordinates of the starting points of the lines.
+/// @param x2 is an array of the x coordinates of the ending points of the lines.
+/// @param y2 is an array of the y coordinates of the ending points of the lines.
+/// @param colors is an array of the colors of the lines.
+/// @param line_count is the number of lines.
+/// @param pixel_width is the width of a pixel, in the coordinates of the lines.
+/// @param pixels is the image to draw to.
+/// @param width is the width of the image in pixels.
+/// @param height is the height of the image in pixels.
+/// @param thread_count is the number of threads to use, including the calling thread.
+/// @returns true if the lines were drawn, false if memory for the tile lists could not be allocated.
+/// @remarks The image is exactly the same as calling drawline_include_endpoints() for every line in order.
+/// Every line is binned into the tiles it crosses by traversing it with squares of
+/// (pixel_width * DRAW_LINE_PARALLEL_TILE_SIZE), clipped to the tiles of the image, and every tile is drawn by one
+/// thread, in the order of the lines, so no two threads write the same pixel.
+bool drawlines_parallel_include_endpoints(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    const uint32_t *colors, int32_t line_count, int32_t pixel_width, uint32_t *pixels, int width, int height,
+    int32_t thread_count);
+
+/// Draws many lines excluding their endpoints, splitting the image into tiles which are drawn by multiple threads.
+/// @param x1 is an array of the x coordinates of the starting points of the lines.
+/// @param y1 is an array of the y coordinates of the starting points of the lines.
+/// @param x2 is an array of the x coordinates of the ending points of the lines.
+/// @param y2 is an array of the y coordinates of the ending points of the lines.
+/// @param colors is an array of the colors of the lines.
+/// @param line_count is the number of lines.
+/// @param pixel_width is the width of a pixel, in the coordinates of the lines.
+/// @param pixels is the image to draw to.
+/// @param width is the width of the image in pixels.
+/// @param height is the height of the image in pixels.
+/// @param thread_count is the number of threads to use, including the calling thread.
+/// @returns true if the lines were drawn, false if memory for the tile lists could not be allocated.
+/// @remarks The image is exactly the same as calling drawline_exclude_endpoints() for every line in order.
+bool drawlines_parallel_exclude_endpoints(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    const uint32_t *colors, int32_t line_count, int32_t pixel_width, uint32_t *pixels, int width, int height,
+    int32_t thread_count);
+
+#endif // DRAW_LINE_PARALLEL_H
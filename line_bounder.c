@@ -3,7 +3,12 @@
 /// Provides functions for bounding a line inside a rectangle.
 
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include "line_bounder.h"
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
 #ifndef min
 #define min(a, b) (((a) < (b)) ? (a) : (b))
@@ -12,6 +17,8 @@
 #define max(a, b) (((a) > (b)) ? (a) : (b))
 #endif
 
+__extension__ typedef __int128 line_bounder_int128;
+
 bool line_bounded_fract_less(int32_t a_numerator, int32_t a_denominator, 
     int32_t b_numerator, int32_t b_denominator)
 {
@@ -159,6 +166,787 @@ bool line_bound_inside_rect(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
 }
 
 
+bool line_bounded_fract_less64(int64_t a_numerator, int64_t a_denominator,
+    int64_t b_numerator, int64_t b_denominator)
+{
+    return ((line_bounder_int128)a_numerator * b_denominator) < ((line_bounder_int128)b_numerator * a_denominator);
+}
+
+/// Gets the near and far t of the intersection of a line with 64 bit coordinates and a rectangle.
+/// This is line_rectangle_intersection_near() and line_rectangle_intersection_far() combined.
+void line_rectangle_intersection64(int64_t x1, int64_t y1, int64_t x2, int64_t y2,
+    int64_t x_min, int64_t x_max, int64_t y_min, int64_t y_max,
+    int64_t *out_near_numerator, int64_t *out_near_denominator,
+    int64_t *out_far_numerator, int64_t *out_far_denominator)
+{
+    int64_t dx = x2 - x1;
+    int64_t dy = y2 - y1;
+
+    int64_t t1x_numerator = ((dx >= 0) ? x_min : x_max) - x1;
+    int64_t t1y_numerator = ((dy >= 0) ? y_min : y_max) - y1;
+    int64_t t2x_numerator = ((dx >= 0) ? x_max : x_min) - x1;
+    int64_t t2y_numerator = ((dy >= 0) ? y_max : y_min) - y1;
+
+    t1x_numerator = (dx < 0) ? (-t1x_numerator) : t1x_numerator;
+    t1y_numerator = (dy < 0) ? (-t1y_numerator) : t1y_numerator;
+    t2x_numerator = (dx < 0) ? (-t2x_numerator) : t2x_numerator;
+    t2y_numerator = (dy < 0) ? (-t2y_numerator) : t2y_numerator;
+    int64_t tx_denominator = (dx < 0) ? -dx : dx;
+    int64_t ty_denominator = (dy < 0) ? -dy : dy;
+
+    *out_near_numerator = t1x_numerator;
+    *out_near_denominator = tx_denominator;
+    if (line_bounded_fract_less64(t1x_numerator, tx_denominator, t1y_numerator, ty_denominator))
+    {
+        *out_near_numerator = t1y_numerator;
+        *out_near_denominator = ty_denominator;
+    }
+    *out_far_numerator = t2x_numerator;
+    *out_far_denominator = tx_denominator;
+    if (line_bounded_fract_less64(t2y_numerator, ty_denominator, t2x_numerator, tx_denominator))
+    {
+        *out_far_numerator = t2y_numerator;
+        *out_far_denominator = ty_denominator;
+    }
+}
+
+bool line_bound_inside_rect64(int64_t x1, int64_t y1, int64_t x2, int64_t y2,
+    int64_t bounds_min_x, int64_t bounds_min_y, int64_t bounds_max_x, int64_t bounds_max_y,
+    int64_t *out_x1, int64_t *out_y1, int64_t *out_x2, int64_t *out_y2)
+{
+    int64_t dx = x2 - x1;
+    int64_t dy = y2 - y1;
+    if (dx == 0)
+    {
+        *out_x1 = x1;
+        *out_x2 = x2;
+        *out_y1 = max(min(y1, bounds_max_y), bounds_min_y);
+        *out_y2 = max(min(y2, bounds_max_y), bounds_min_y);
+        bool x_in_bounds = x1 >= bounds_min_x && x1 <= bounds_max_x;
+        bool y_in_bounds = min(y1, y2) <= bounds_max_y && max(y1, y2) >= bounds_min_y;
+        return x_in_bounds && y_in_bounds && *out_y2 != *out_y1;
+    }
+    if (dy == 0)
+    {
+        *out_y1 = y1;
+        *out_y2 = y2;
+        *out_x1 = max(min(x1, bounds_max_x), bounds_min_x);
+        *out_x2 = max(min(x2, bounds_max_x), bounds_min_x);
+        bool y_in_bounds = y1 >= bounds_min_y && y1 <= bounds_max_y;
+        bool x_in_bounds = min(x1, x2) <= bounds_max_x && max(x1, x2) >= bounds_min_x;
+        return x_in_bounds && y_in_bounds && *out_x2 != *out_x1;
+    }
+    int64_t t_near_numerator, t_near_denominator;
+    int64_t t_far_numerator, t_far_denominator;
+    line_rectangle_intersection64(x1, y1, x2, y2, bounds_min_x, bounds_max_x, bounds_min_y, bounds_max_y,
+        &t_near_numerator, &t_near_denominator, &t_far_numerator, &t_far_denominator);
+
+    *out_x1 = x1;
+    *out_y1 = y1;
+    *out_x2 = x2;
+    *out_y2 = y2;
+    if ((t_near_numerator ^ t_near_denominator) >= 0)
+    {
+        *out_x1 = (int64_t)(((line_bounder_int128)x1 * t_near_denominator +
+            (line_bounder_int128)t_near_numerator * dx) / t_near_denominator);
+        *out_y1 = (int64_t)(((line_bounder_int128)y1 * t_near_denominator +
+            (line_bounder_int128)t_near_numerator * dy) / t_near_denominator);
+    }
+    if (t_far_numerator < t_far_denominator)
+    {
+        *out_x2 = (int64_t)(((line_bounder_int128)x1 * t_far_denominator +
+            (line_bounder_int128)t_far_numerator * dx) / t_far_denominator);
+        *out_y2 = (int64_t)(((line_bounder_int128)y1 * t_far_denominator +
+            (line_bounder_int128)t_far_numerator * dy) / t_far_denominator);
+    }
+    bool hit = line_bounded_fract_less64(t_near_numerator, t_near_denominator, t_far_numerator, t_far_denominator);
+    hit &= t_near_numerator < t_near_denominator;
+    hit &= t_far_numerator > 0;
+    return hit;
+}
+
+
+/// Narrows the parameter range [t_begin, t_end] of a line to where one coordinate is inside [v_min, v_max].
+/// Returns false if the coordinate is never inside.
+bool line_bound_axis_t_range(int32_t v1, int32_t v2, int32_t v_min, int32_t v_max,
+    int64_t *p_t_begin_numerator, int64_t *p_t_begin_denominator,
+    int64_t *p_t_end_numerator, int64_t *p_t_end_denominator)
+{
+    int64_t dv = (int64_t)v2 - v1;
+    if (dv == 0)
+        return v1 >= v_min && v1 <= v_max;
+    int64_t enter_numerator = (dv > 0) ? ((int64_t)v_min - v1) : ((int64_t)v1 - v_max);
+    int64_t exit_numerator = (dv > 0) ? ((int64_t)v_max - v1) : ((int64_t)v1 - v_min);
+    int64_t denominator = (dv > 0) ? dv : -dv;
+    if (line_bounded_fract_less64(*p_t_begin_numerator, *p_t_begin_denominator, enter_numerator, denominator))
+    {
+        *p_t_begin_numerator = enter_numerator;
+        *p_t_begin_denominator = denominator;
+    }
+    if (line_bounded_fract_less64(exit_numerator, denominator, *p_t_end_numerator, *p_t_end_denominator))
+    {
+        *p_t_end_numerator = exit_numerator;
+        *p_t_end_denominator = denominator;
+    }
+    return true;
+}
+
+bool line_bound_traverser_inside_rect(LineTraverser *p_out_traverser, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t bounds_min_x, int32_t bounds_min_y, int32_t bounds_max_x, int32_t bounds_max_y)
+{
+    int64_t t_begin_numerator = 0, t_begin_denominator = 1;
+    int64_t t_end_numerator = 1, t_end_denominator = 1;
+    if (!line_bound_axis_t_range(x1, x2, bounds_min_x, bounds_max_x,
+        &t_begin_numerator, &t_begin_denominator, &t_end_numerator, &t_end_denominator))
+        return false;
+    if (!line_bound_axis_t_range(y1, y2, bounds_min_y, bounds_max_y,
+        &t_begin_numerator, &t_begin_denominator, &t_end_numerator, &t_end_denominator))
+        return false;
+    // Like line_bound_inside_rect(), a line that only touches the region at a single point is not inside it.
+    if (!line_bounded_fract_less64(t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator))
+        return false;
+    return LineTraverser_init_range(p_out_traverser, x1, y1, x2, y2, square_width,
+        t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator);
+}
+
+
+int32_t line_bound_inside_rects(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    const int32_t *bounds_min_x, const int32_t *bounds_min_y, const int32_t *bounds_max_x, const int32_t *bounds_max_y,
+    int32_t bounds_count, int64_t *out_t_begin_numerators, int64_t *out_t_begin_denominators,
+    int64_t *out_t_end_numerators, int64_t *out_t_end_denominators)
+{
+    // The sides of the regions that the line enters and exits through only depend on the direction of the line.
+    int64_t dx = (int64_t)x2 - x1;
+    int64_t dy = (int64_t)y2 - y1;
+    int64_t x_sign = (dx >= 0) ? 1 : -1;
+    int64_t y_sign = (dy >= 0) ? 1 : -1;
+    int64_t x_denominator = dx * x_sign;
+    int64_t y_denominator = dy * y_sign;
+    const int32_t *x_enter_bounds = (dx >= 0) ? bounds_min_x : bounds_max_x;
+    const int32_t *x_exit_bounds = (dx >= 0) ? bounds_max_x : bounds_min_x;
+    const int32_t *y_enter_bounds = (dy >= 0) ? bounds_min_y : bounds_max_y;
+    const int32_t *y_exit_bounds = (dy >= 0) ? bounds_max_y : bounds_min_y;
+
+    int32_t range_count = 0;
+    for (int32_t i = 0; i < bounds_count; i++)
+    {
+        int64_t t_begin_numerator = 0, t_begin_denominator = 1;
+        int64_t t_end_numerator = 1, t_end_denominator = 1;
+        if (dx == 0)
+        {
+            if (x1 < bounds_min_x[i] || x1 > bounds_max_x[i])
+                continue;
+        }
+        else
+        {
+            int64_t enter_numerator = (x_enter_bounds[i] - (int64_t)x1) * x_sign;
+            int64_t exit_numerator = (x_exit_bounds[i] - (int64_t)x1) * x_sign;
+            if (enter_numerator > 0)
+            {
+                t_begin_numerator = enter_numerator;
+                t_begin_denominator = x_denominator;
+            }
+            if (exit_numerator < x_denominator)
+            {
+                t_end_numerator = exit_numerator;
+                t_end_denominator = x_denominator;
+            }
+        }
+        if (dy == 0)
+        {
+            if (y1 < bounds_min_y[i] || y1 > bounds_max_y[i])
+                continue;
+        }
+        else
+        {
+            int64_t enter_numerator = (y_enter_bounds[i] - (int64_t)y1) * y_sign;
+            int64_t exit_numerator = (y_exit_bounds[i] - (int64_t)y1) * y_sign;
+            if (line_bounded_fract_less64(t_begin_numerator, t_begin_denominator, enter_numerator, y_denominator))
+            {
+                t_begin_numerator = enter_numerator;
+                t_begin_denominator = y_denominator;
+            }
+            if (line_bounded_fract_less64(exit_numerator, y_denominator, t_end_numerator, t_end_denominator))
+            {
+                t_end_numerator = exit_numerator;
+                t_end_denominator = y_denominator;
+            }
+        }
+        if (!line_bounded_fract_less64(t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator))
+            continue;
+
+        // Insertion sort by the beginning of the range, since there are usually few regions.
+        int32_t j = range_count++;
+        while (j > 0 && line_bounded_fract_less64(t_begin_numerator, t_begin_denominator,
+            out_t_begin_numerators[j - 1], out_t_begin_denominators[j - 1]))
+        {
+            out_t_begin_numerators[j] = out_t_begin_numerators[j - 1];
+            out_t_begin_denominators[j] = out_t_begin_denominators[j - 1];
+            out_t_end_numerators[j] = out_t_end_numerators[j - 1];
+            out_t_end_denominators[j] = out_t_end_denominators[j - 1];
+            j--;
+        }
+        out_t_begin_numerators[j] = t_begin_numerator;
+        out_t_begin_denominators[j] = t_begin_denominator;
+        out_t_end_numerators[j] = t_end_numerator;
+        out_t_end_denominators[j] = t_end_denominator;
+    }
+
+    // Merge ranges which overlap or touch, so no part of the line is given twice.
+    int32_t merged_count = 0;
+    for (int32_t i = 0; i < range_count; i++)
+    {
+        if (merged_count > 0 && !line_bounded_fract_less64(out_t_end_numerators[merged_count - 1],
+            out_t_end_denominators[merged_count - 1], out_t_begin_numerators[i], out_t_begin_denominators[i]))
+        {
+            if (line_bounded_fract_less64(out_t_end_numerators[merged_count - 1],
+                out_t_end_denominators[merged_count - 1], out_t_end_numerators[i], out_t_end_denominators[i]))
+            {
+                out_t_end_numerators[merged_count - 1] = out_t_end_numerators[i];
+                out_t_end_denominators[merged_count - 1] = out_t_end_denominators[i];
+            }
+            continue;
+        }
+        out_t_begin_numerators[merged_count] = out_t_begin_numerators[i];
+        out_t_begin_denominators[merged_count] = out_t_begin_denominators[i];
+        out_t_end_numerators[merged_count] = out_t_end_numerators[i];
+        out_t_end_denominators[merged_count] = out_t_end_denominators[i];
+        merged_count++;
+    }
+    return merged_count;
+}
+
+bool line_bound_traverse_inside_rects(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+    const int32_t *bounds_min_x, const int32_t *bounds_min_y, const int32_t *bounds_max_x, const int32_t *bounds_max_y,
+    int32_t bounds_count, LineTraverserCallback callback, void *user_data)
+{
+    if (bounds_count <= 0)
+        return true;
+    int64_t *ranges = (int64_t*)malloc(sizeof(int64_t) * 4 * bounds_count);
+    if (!ranges)
+        return false;
+    int64_t *t_begin_numerators = ranges;
+    int64_t *t_begin_denominators = ranges + bounds_count;
+    int64_t *t_end_numerators = ranges + 2 * bounds_count;
+    int64_t *t_end_denominators = ranges + 3 * bounds_count;
+    int32_t range_count = line_bound_inside_rects(x1, y1, x2, y2,
+        bounds_min_x, bounds_min_y, bounds_max_x, bounds_max_y, bounds_count,
+        t_begin_numerators, t_begin_denominators, t_end_numerators, t_end_denominators);
+
+    bool has_previous = false;
+    int32_t previous_x = 0, previous_y = 0;
+    for (int32_t i = 0; i < range_count; i++)
+    {
+        LineTraverser traverser;
+        if (!LineTraverser_init_range(&traverser, x1, y1, x2, y2, square_width,
+            t_begin_numerators[i], t_begin_denominators[i], t_end_numerators[i], t_end_denominators[i]))
+            continue;
+        int32_t x, y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        // A range can begin in the grid square that the previous range ended in.
+        bool skip = has_previous && x == previous_x && y == previous_y;
+        while (true)
+        {
+            LineTraverser_get_point(&traverser, &x, &y);
+            if (!skip)
+                callback(x, y, user_data);
+            skip = false;
+            if (LineTraverser_is_end(&traverser))
+                break;
+            LineTraverser_next(&traverser);
+        }
+        has_previous = true;
+        previous_x = x;
+        previous_y = y;
+    }
+    free(ranges);
+    return true;
+}
+
+bool LineBoundPolygon_init(LineBoundPolygon *p_polygon, const int32_t *x, const int32_t *y, int32_t vertex_count)
+{
+    memset(p_polygon, 0, sizeof(LineBoundPolygon));
+    if (vertex_count < 3)
+        return false;
+    line_bounder_int128 twice_area = 0;
+    for (int32_t i = 0; i < vertex_count; i++)
+    {
+        int32_t j = (i + 1) % vertex_count;
+        twice_area += (line_bounder_int128)x[i] * y[j] - (line_bounder_int128)x[j] * y[i];
+    }
+    if (twice_area == 0)
+        return false;
+    int64_t orientation = (twice_area > 0) ? 1 : -1;
+    // Every corner between edges of non-zero length must turn the same way as the whole polygon, without
+    // doubling back. That alone also passes self-intersecting stars, which turn around more than once, so the
+    // edge directions must also change sign at most twice along each axis.
+    int64_t previous_dx = 0, previous_dy = 0;
+    for (int32_t i = vertex_count - 1; i >= 0 && previous_dx == 0 && previous_dy == 0; i--)
+    {
+        int32_t j = (i + 1) % vertex_count;
+        previous_dx = (int64_t)x[j] - x[i];
+        previous_dy = (int64_t)y[j] - y[i];
+    }
+    int32_t first_sign_x = 0, first_sign_y = 0, sign_x = 0, sign_y = 0;
+    int32_t sign_changes_x = 0, sign_changes_y = 0;
+    for (int32_t i = 0; i < vertex_count; i++)
+    {
+        int32_t j = (i + 1) % vertex_count;
+        int64_t dx = (int64_t)x[j] - x[i];
+        int64_t dy = (int64_t)y[j] - y[i];
+        if (dx == 0 && dy == 0)
+            continue;
+        int64_t turn = previous_dx * dy - previous_dy * dx;
+        if (turn * orientation < 0 || (turn == 0 && previous_dx * dx + previous_dy * dy < 0))
+            return false;
+        previous_dx = dx;
+        previous_dy = dy;
+        int32_t edge_sign_x = (dx > 0) - (dx < 0);
+        int32_t edge_sign_y = (dy > 0) - (dy < 0);
+        if (edge_sign_x != 0)
+        {
+            sign_changes_x += (sign_x != 0 && edge_sign_x != sign_x);
+            first_sign_x = (first_sign_x != 0) ? first_sign_x : edge_sign_x;
+            sign_x = edge_sign_x;
+        }
+        if (edge_sign_y != 0)
+        {
+            sign_changes_y += (sign_y != 0 && edge_sign_y != sign_y);
+            first_sign_y = (first_sign_y != 0) ? first_sign_y : edge_sign_y;
+            sign_y = edge_sign_y;
+        }
+    }
+    sign_changes_x += (first_sign_x != sign_x);
+    sign_changes_y += (first_sign_y != sign_y);
+    if (sign_changes_x > 2 || sign_changes_y > 2)
+        return false;
+
+    p_polygon->normal_x = (int64_t*)malloc(sizeof(int64_t) * 3 * vertex_count);
+    if (!p_polygon->normal_x)
+        return false;
+    p_polygon->normal_y = p_polygon->normal_x + vertex_count;
+    p_polygon->offset = p_polygon->normal_x + 2 * vertex_count;
+    p_polygon->edge_count = vertex_count;
+    p_polygon->bounds_min_x = p_polygon->bounds_max_x = x[0];
+    p_polygon->bounds_min_y = p_polygon->bounds_max_y = y[0];
+    for (int32_t i = 0; i < vertex_count; i++)
+    {
+        int32_t j = (i + 1) % vertex_count;
+        p_polygon->normal_x[i] = ((int64_t)y[i] - y[j]) * orientation;
+        p_polygon->normal_y[i] = ((int64_t)x[j] - x[i]) * orientation;
+        p_polygon->offset[i] = p_polygon->normal_x[i] * x[i] + p_polygon->normal_y[i] * y[i];
+        p_polygon->bounds_min_x = min(p_polygon->bounds_min_x, x[i]);
+        p_polygon->bounds_min_y = min(p_polygon->bounds_min_y, y[i]);
+        p_polygon->bounds_max_x = max(p_polygon->bounds_max_x, x[i]);
+        p_polygon->bounds_max_y = max(p_polygon->bounds_max_y, y[i]);
+    }
+    return true;
+}
+
+void LineBoundPolygon_destroy(LineBoundPolygon *p_polygon)
+{
+    free(p_polygon->normal_x);
+    memset(p_polygon, 0, sizeof(LineBoundPolygon));
+}
+
+bool line_bound_inside_polygon(const LineBoundPolygon *p_polygon, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int64_t *out_t_begin_numerator, int64_t *out_t_begin_denominator,
+    int64_t *out_t_end_numerator, int64_t *out_t_end_denominator)
+{
+    if ((x1 < p_polygon->bounds_min_x && x2 < p_polygon->bounds_min_x) ||
+        (x1 > p_polygon->bounds_max_x && x2 > p_polygon->bounds_max_x) ||
+        (y1 < p_polygon->bounds_min_y && y2 < p_polygon->bounds_min_y) ||
+        (y1 > p_polygon->bounds_max_y && y2 > p_polygon->bounds_max_y))
+        return false;
+    int64_t dx = (int64_t)x2 - x1;
+    int64_t dy = (int64_t)y2 - y1;
+    int64_t t_begin_numerator = 0, t_begin_denominator = 1;
+    int64_t t_end_numerator = 1, t_end_denominator = 1;
+    for (int32_t i = 0; i < p_polygon->edge_count; i++)
+    {
+        // The line is inside of edge i where t * denominator >= numerator. Every product is less than 2^62, so
+        // both sums fit while the coordinates are strictly within +-2^30.
+        int64_t numerator = p_polygon->offset[i] - p_polygon->normal_x[i] * x1 - p_polygon->normal_y[i] * y1;
+        int64_t denominator = p_polygon->normal_x[i] * dx + p_polygon->normal_y[i] * dy;
+        if (denominator == 0)
+        {
+            if (numerator > 0)
+                return false;
+            continue;
+        }
+        if (denominator > 0)
+        {
+            if (line_bounded_fract_less64(t_begin_numerator, t_begin_denominator, numerator, denominator))
+            {
+                t_begin_numerator = numerator;
+                t_begin_denominator = denominator;
+            }
+        }
+        else if (line_bounded_fract_less64(-numerator, -denominator, t_end_numerator, t_end_denominator))
+        {
+            t_end_numerator = -numerator;
+            t_end_denominator = -denominator;
+        }
+        if (!line_bounded_fract_less64(t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator))
+            return false;
+    }
+    *out_t_begin_numerator = t_begin_numerator;
+    *out_t_begin_denominator = t_begin_denominator;
+    *out_t_end_numerator = t_end_numerator;
+    *out_t_end_denominator = t_end_denominator;
+    return true;
+}
+
+bool line_bound_traverser_inside_polygon(LineTraverser *p_out_traverser, const LineBoundPolygon *p_polygon,
+    int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    int64_t t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator;
+    if (!line_bound_inside_polygon(p_polygon, x1, y1, x2, y2,
+        &t_begin_numerator, &t_begin_denominator, &t_end_numerator, &t_end_denominator))
+        return false;
+    return LineTraverser_init_range(p_out_traverser, x1, y1, x2, y2, square_width,
+        t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator);
+}
+
+void line_bound_inside_polygon_batch(const LineBoundPolygon *p_polygon,
+    const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2, int32_t count,
+    uint32_t *out_hit_masks, int64_t *out_t_begin_numerators, int64_t *out_t_begin_denominators,
+    int64_t *out_t_end_numerators, int64_t *out_t_end_denominators)
+{
+    for (int32_t word = 0; word < (count + 31) / 32; word++)
+    {
+        uint32_t hits = 0;
+        int32_t end = min(count, word * 32 + 32);
+        for (int32_t i = word * 32; i < end; i++)
+        {
+            if (line_bound_inside_polygon(p_polygon, x1[i], y1[i], x2[i], y2[i],
+                &out_t_begin_numerators[i], &out_t_begin_denominators[i],
+                &out_t_end_numerators[i], &out_t_end_denominators[i]))
+                hits |= (uint32_t)1 << (i % 32);
+        }
+        out_hit_masks[word] = hits;
+    }
+}
+
+/// Bounds one line of line_bound_inside_rect_batch(), trivially accepting or rejecting it when possible.
+bool line_bound_batch_line(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t bounds_min_x, int32_t bounds_min_y, int32_t bounds_max_x, int32_t bounds_max_y,
+    int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2)
+{
+    bool inside1 = x1 >= bounds_min_x && x1 <= bounds_max_x && y1 >= bounds_min_y && y1 <= bounds_max_y;
+    bool inside2 = x2 >= bounds_min_x && x2 <= bounds_max_x && y2 >= bounds_min_y && y2 <= bounds_max_y;
+    if (inside1 && inside2 && (x1 != x2 || y1 != y2))
+    {
+        *out_x1 = x1;
+        *out_y1 = y1;
+        *out_x2 = x2;
+        *out_y2 = y2;
+        return true;
+    }
+    if ((x1 < bounds_min_x && x2 < bounds_min_x) || (x1 > bounds_max_x && x2 > bounds_max_x) ||
+        (y1 < bounds_min_y && y2 < bounds_min_y) || (y1 > bounds_max_y && y2 > bounds_max_y))
+        return false;
+    int64_t bounded_x1, bounded_y1, bounded_x2, bounded_y2;
+    bool hit = line_bound_inside_rect64(x1, y1, x2, y2, bounds_min_x, bounds_min_y, bounds_max_x, bounds_max_y,
+        &bounded_x1, &bounded_y1, &bounded_x2, &bounded_y2);
+    *out_x1 = (int32_t)bounded_x1;
+    *out_y1 = (int32_t)bounded_y1;
+    *out_x2 = (int32_t)bounded_x2;
+    *out_y2 = (int32_t)bounded_y2;
+    return hit;
+}
+
+#if defined(__AVX512F__)
+
+#define LINE_BOUND_BATCH_WIDTH 8
+
+/// Bounds LINE_BOUND_BATCH_WIDTH lines of line_bound_inside_rect_batch() at once, with a lane per line.
+/// @returns a mask with a bit set for each line inside the region.
+static inline uint32_t line_bound_batch_lanes(const int32_t *x1, const int32_t *y1,
+    const int32_t *x2, const int32_t *y2, __m512d min_x, __m512d min_y, __m512d max_x, __m512d max_y,
+    int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2)
+{
+    // The zero masked forms are used because the unmasked ones make GCC warn about their undefined source.
+    const __mmask8 all = 0xFF;
+    __m256i x1i = _mm256_loadu_si256((const __m256i *)x1);
+    __m256i y1i = _mm256_loadu_si256((const __m256i *)y1);
+    __m256i x2i = _mm256_loadu_si256((const __m256i *)x2);
+    __m256i y2i = _mm256_loadu_si256((const __m256i *)y2);
+    __m512d x1d = _mm512_maskz_cvtepi32_pd(all, x1i);
+    __m512d y1d = _mm512_maskz_cvtepi32_pd(all, y1i);
+    __m512d x2d = _mm512_maskz_cvtepi32_pd(all, x2i);
+    __m512d y2d = _mm512_maskz_cvtepi32_pd(all, y2i);
+    __m512d zero = _mm512_setzero_pd();
+    __m512d dx = _mm512_sub_pd(x2d, x1d);
+    __m512d dy = _mm512_sub_pd(y2d, y1d);
+    __mmask8 dx_zero = _mm512_cmp_pd_mask(dx, zero, _CMP_EQ_OQ);
+    __mmask8 dy_zero = _mm512_cmp_pd_mask(dy, zero, _CMP_EQ_OQ);
+
+    // Trivially accept lines with both endpoints inside, and reject lines with both endpoints past one side.
+    __mmask8 inside = _mm512_cmp_pd_mask(x1d, min_x, _CMP_GE_OQ) & _mm512_cmp_pd_mask(x1d, max_x, _CMP_LE_OQ) &
+        _mm512_cmp_pd_mask(y1d, min_y, _CMP_GE_OQ) & _mm512_cmp_pd_mask(y1d, max_y, _CMP_LE_OQ) &
+        _mm512_cmp_pd_mask(x2d, min_x, _CMP_GE_OQ) & _mm512_cmp_pd_mask(x2d, max_x, _CMP_LE_OQ) &
+        _mm512_cmp_pd_mask(y2d, min_y, _CMP_GE_OQ) & _mm512_cmp_pd_mask(y2d, max_y, _CMP_LE_OQ);
+    __mmask8 accept = inside & ~(dx_zero & dy_zero);
+    __mmask8 reject = (_mm512_cmp_pd_mask(x1d, min_x, _CMP_LT_OQ) & _mm512_cmp_pd_mask(x2d, min_x, _CMP_LT_OQ)) |
+        (_mm512_cmp_pd_mask(x1d, max_x, _CMP_GT_OQ) & _mm512_cmp_pd_mask(x2d, max_x, _CMP_GT_OQ)) |
+        (_mm512_cmp_pd_mask(y1d, min_y, _CMP_LT_OQ) & _mm512_cmp_pd_mask(y2d, min_y, _CMP_LT_OQ)) |
+        (_mm512_cmp_pd_mask(y1d, max_y, _CMP_GT_OQ) & _mm512_cmp_pd_mask(y2d, max_y, _CMP_GT_OQ));
+    if ((__mmask8)(accept | reject) == 0xFF)
+    {
+        _mm256_storeu_si256((__m256i *)out_x1, x1i);
+        _mm256_storeu_si256((__m256i *)out_y1, y1i);
+        _mm256_storeu_si256((__m256i *)out_x2, x2i);
+        _mm256_storeu_si256((__m256i *)out_y2, y2i);
+        return accept;
+    }
+
+    // The near and far t of each line, as fractions with positive denominators, like line_rectangle_intersection64().
+    __mmask8 dx_negative = _mm512_cmp_pd_mask(dx, zero, _CMP_LT_OQ);
+    __mmask8 dy_negative = _mm512_cmp_pd_mask(dy, zero, _CMP_LT_OQ);
+    __m512d abs_dx = _mm512_abs_pd(dx);
+    __m512d abs_dy = _mm512_abs_pd(dy);
+    __m512d t1x_numerator = _mm512_mask_blend_pd(dx_negative, _mm512_sub_pd(min_x, x1d), _mm512_sub_pd(x1d, max_x));
+    __m512d t2x_numerator = _mm512_mask_blend_pd(dx_negative, _mm512_sub_pd(max_x, x1d), _mm512_sub_pd(x1d, min_x));
+    __m512d t1y_numerator = _mm512_mask_blend_pd(dy_negative, _mm512_sub_pd(min_y, y1d), _mm512_sub_pd(y1d, max_y));
+    __m512d t2y_numerator = _mm512_mask_blend_pd(dy_negative, _mm512_sub_pd(max_y, y1d), _mm512_sub_pd(y1d, min_y));
+    __mmask8 near_is_y = _mm512_cmp_pd_mask(_mm512_mul_pd(t1y_numerator, abs_dx),
+        _mm512_mul_pd(t1x_numerator, abs_dy), _CMP_GT_OQ);
+    __m512d near_numerator = _mm512_mask_blend_pd(near_is_y, t1x_numerator, t1y_numerator);
+    __m512d near_denominator = _mm512_mask_blend_pd(near_is_y, abs_dx, abs_dy);
+    __mmask8 far_is_y = _mm512_cmp_pd_mask(_mm512_mul_pd(t2y_numerator, abs_dx),
+        _mm512_mul_pd(t2x_numerator, abs_dy), _CMP_LT_OQ);
+    __m512d far_numerator = _mm512_mask_blend_pd(far_is_y, t2x_numerator, t2y_numerator);
+    __m512d far_denominator = _mm512_mask_blend_pd(far_is_y, abs_dx, abs_dy);
+
+    __mmask8 clip_near = _mm512_cmp_pd_mask(near_numerator, zero, _CMP_GE_OQ);
+    __mmask8 clip_far = _mm512_cmp_pd_mask(far_numerator, far_denominator, _CMP_LT_OQ);
+    __m512d bounded_x1 = _mm512_mask_blend_pd(clip_near, x1d, _mm512_div_pd(_mm512_fmadd_pd(x1d, near_denominator,
+        _mm512_mul_pd(near_numerator, dx)), near_denominator));
+    __m512d bounded_y1 = _mm512_mask_blend_pd(clip_near, y1d, _mm512_div_pd(_mm512_fmadd_pd(y1d, near_denominator,
+        _mm512_mul_pd(near_numerator, dy)), near_denominator));
+    __m512d bounded_x2 = _mm512_mask_blend_pd(clip_far, x2d, _mm512_div_pd(_mm512_fmadd_pd(x1d, far_denominator,
+        _mm512_mul_pd(far_numerator, dx)), far_denominator));
+    __m512d bounded_y2 = _mm512_mask_blend_pd(clip_far, y2d, _mm512_div_pd(_mm512_fmadd_pd(y1d, far_denominator,
+        _mm512_mul_pd(far_numerator, dy)), far_denominator));
+    __mmask8 hit = _mm512_cmp_pd_mask(_mm512_mul_pd(near_numerator, far_denominator),
+        _mm512_mul_pd(far_numerator, near_denominator), _CMP_LT_OQ) &
+        _mm512_cmp_pd_mask(near_numerator, near_denominator, _CMP_LT_OQ) &
+        _mm512_cmp_pd_mask(far_numerator, zero, _CMP_GT_OQ);
+
+    // Vertical and horizontal lines are clamped to the region.
+    __m512d clamped_y1 = _mm512_maskz_max_pd(all, _mm512_maskz_min_pd(all, y1d, max_y), min_y);
+    __m512d clamped_y2 = _mm512_maskz_max_pd(all, _mm512_maskz_min_pd(all, y2d, max_y), min_y);
+    __mmask8 vertical_hit = _mm512_cmp_pd_mask(x1d, min_x, _CMP_GE_OQ) & _mm512_cmp_pd_mask(x1d, max_x, _CMP_LE_OQ) &
+        _mm512_cmp_pd_mask(_mm512_maskz_min_pd(all, y1d, y2d), max_y, _CMP_LE_OQ) &
+        _mm512_cmp_pd_mask(_mm512_maskz_max_pd(all, y1d, y2d), min_y, _CMP_GE_OQ) &
+        _mm512_cmp_pd_mask(clamped_y1, clamped_y2, _CMP_NEQ_OQ);
+    __m512d clamped_x1 = _mm512_maskz_max_pd(all, _mm512_maskz_min_pd(all, x1d, max_x), min_x);
+    __m512d clamped_x2 = _mm512_maskz_max_pd(all, _mm512_maskz_min_pd(all, x2d, max_x), min_x);
+    __mmask8 horizontal_hit = _mm512_cmp_pd_mask(y1d, min_y, _CMP_GE_OQ) &
+        _mm512_cmp_pd_mask(y1d, max_y, _CMP_LE_OQ) &
+        _mm512_cmp_pd_mask(_mm512_maskz_min_pd(all, x1d, x2d), max_x, _CMP_LE_OQ) &
+        _mm512_cmp_pd_mask(_mm512_maskz_max_pd(all, x1d, x2d), min_x, _CMP_GE_OQ) &
+        _mm512_cmp_pd_mask(clamped_x1, clamped_x2, _CMP_NEQ_OQ);
+    __mmask8 horizontal = dy_zero & ~dx_zero;
+    bounded_x1 = _mm512_mask_blend_pd(horizontal, _mm512_mask_blend_pd(dx_zero, bounded_x1, x1d), clamped_x1);
+    bounded_x2 = _mm512_mask_blend_pd(horizontal, _mm512_mask_blend_pd(dx_zero, bounded_x2, x2d), clamped_x2);
+    bounded_y1 = _mm512_mask_blend_pd(horizontal, _mm512_mask_blend_pd(dx_zero, bounded_y1, clamped_y1), y1d);
+    bounded_y2 = _mm512_mask_blend_pd(horizontal, _mm512_mask_blend_pd(dx_zero, bounded_y2, clamped_y2), y2d);
+    hit = (hit & ~dx_zero & ~horizontal) | (vertical_hit & dx_zero) | (horizontal_hit & horizontal);
+
+    _mm256_storeu_si256((__m256i *)out_x1, _mm512_maskz_cvttpd_epi32(all, bounded_x1));
+    _mm256_storeu_si256((__m256i *)out_y1, _mm512_maskz_cvttpd_epi32(all, bounded_y1));
+    _mm256_storeu_si256((__m256i *)out_x2, _mm512_maskz_cvttpd_epi32(all, bounded_x2));
+    _mm256_storeu_si256((__m256i *)out_y2, _mm512_maskz_cvttpd_epi32(all, bounded_y2));
+    return hit;
+}
+
+#elif defined(__AVX2__)
+
+#define LINE_BOUND_BATCH_WIDTH 4
+
+/// Bounds LINE_BOUND_BATCH_WIDTH lines of line_bound_inside_rect_batch() at once, with a lane per line.
+/// @returns a mask with a bit set for each line inside the region.
+static inline uint32_t line_bound_batch_lanes(const int32_t *x1, const int32_t *y1,
+    const int32_t *x2, const int32_t *y2, __m256d min_x, __m256d min_y, __m256d max_x, __m256d max_y,
+    int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2)
+{
+    __m128i x1i = _mm_loadu_si128((const __m128i *)x1);
+    __m128i y1i = _mm_loadu_si128((const __m128i *)y1);
+    __m128i x2i = _mm_loadu_si128((const __m128i *)x2);
+    __m128i y2i = _mm_loadu_si128((const __m128i *)y2);
+    __m256d x1d = _mm256_cvtepi32_pd(x1i);
+    __m256d y1d = _mm256_cvtepi32_pd(y1i);
+    __m256d x2d = _mm256_cvtepi32_pd(x2i);
+    __m256d y2d = _mm256_cvtepi32_pd(y2i);
+    __m256d zero = _mm256_setzero_pd();
+    __m256d dx = _mm256_sub_pd(x2d, x1d);
+    __m256d dy = _mm256_sub_pd(y2d, y1d);
+    __m256d dx_zero = _mm256_cmp_pd(dx, zero, _CMP_EQ_OQ);
+    __m256d dy_zero = _mm256_cmp_pd(dy, zero, _CMP_EQ_OQ);
+
+    // Trivially accept lines with both endpoints inside, and reject lines with both endpoints past one side.
+    __m256d inside = _mm256_and_pd(
+        _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(x1d, min_x, _CMP_GE_OQ), _mm256_cmp_pd(x1d, max_x, _CMP_LE_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(y1d, min_y, _CMP_GE_OQ), _mm256_cmp_pd(y1d, max_y, _CMP_LE_OQ))),
+        _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(x2d, min_x, _CMP_GE_OQ), _mm256_cmp_pd(x2d, max_x, _CMP_LE_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(y2d, min_y, _CMP_GE_OQ), _mm256_cmp_pd(y2d, max_y, _CMP_LE_OQ))));
+    __m256d accept = _mm256_andnot_pd(_mm256_and_pd(dx_zero, dy_zero), inside);
+    __m256d reject = _mm256_or_pd(
+        _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(x1d, min_x, _CMP_LT_OQ), _mm256_cmp_pd(x2d, min_x, _CMP_LT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(x1d, max_x, _CMP_GT_OQ), _mm256_cmp_pd(x2d, max_x, _CMP_GT_OQ))),
+        _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(y1d, min_y, _CMP_LT_OQ), _mm256_cmp_pd(y2d, min_y, _CMP_LT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(y1d, max_y, _CMP_GT_OQ), _mm256_cmp_pd(y2d, max_y, _CMP_GT_OQ))));
+    if (_mm256_movemask_pd(_mm256_or_pd(accept, reject)) == 0xF)
+    {
+        _mm_storeu_si128((__m128i *)out_x1, x1i);
+        _mm_storeu_si128((__m128i *)out_y1, y1i);
+        _mm_storeu_si128((__m128i *)out_x2, x2i);
+        _mm_storeu_si128((__m128i *)out_y2, y2i);
+        return (uint32_t)_mm256_movemask_pd(accept);
+    }
+
+    // The near and far t of each line, as fractions with positive denominators, like line_rectangle_intersection64().
+    __m256d dx_negative = _mm256_cmp_pd(dx, zero, _CMP_LT_OQ);
+    __m256d dy_negative = _mm256_cmp_pd(dy, zero, _CMP_LT_OQ);
+    __m256d sign_bit = _mm256_set1_pd(-0.0);
+    __m256d abs_dx = _mm256_andnot_pd(sign_bit, dx);
+    __m256d abs_dy = _mm256_andnot_pd(sign_bit, dy);
+    __m256d t1x_numerator = _mm256_blendv_pd(_mm256_sub_pd(min_x, x1d), _mm256_sub_pd(x1d, max_x), dx_negative);
+    __m256d t2x_numerator = _mm256_blendv_pd(_mm256_sub_pd(max_x, x1d), _mm256_sub_pd(x1d, min_x), dx_negative);
+    __m256d t1y_numerator = _mm256_blendv_pd(_mm256_sub_pd(min_y, y1d), _mm256_sub_pd(y1d, max_y), dy_negative);
+    __m256d t2y_numerator = _mm256_blendv_pd(_mm256_sub_pd(max_y, y1d), _mm256_sub_pd(y1d, min_y), dy_negative);
+    __m256d near_is_y = _mm256_cmp_pd(_mm256_mul_pd(t1y_numerator, abs_dx),
+        _mm256_mul_pd(t1x_numerator, abs_dy), _CMP_GT_OQ);
+    __m256d near_numerator = _mm256_blendv_pd(t1x_numerator, t1y_numerator, near_is_y);
+    __m256d near_denominator = _mm256_blendv_pd(abs_dx, abs_dy, near_is_y);
+    __m256d far_is_y = _mm256_cmp_pd(_mm256_mul_pd(t2y_numerator, abs_dx),
+        _mm256_mul_pd(t2x_numerator, abs_dy), _CMP_LT_OQ);
+    __m256d far_numerator = _mm256_blendv_pd(t2x_numerator, t2y_numerator, far_is_y);
+    __m256d far_denominator = _mm256_blendv_pd(abs_dx, abs_dy, far_is_y);
+
+    __m256d clip_near = _mm256_cmp_pd(near_numerator, zero, _CMP_GE_OQ);
+    __m256d clip_far = _mm256_cmp_pd(far_numerator, far_denominator, _CMP_LT_OQ);
+    __m256d bounded_x1 = _mm256_blendv_pd(x1d, _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(x1d, near_denominator),
+        _mm256_mul_pd(near_numerator, dx)), near_denominator), clip_near);
+    __m256d bounded_y1 = _mm256_blendv_pd(y1d, _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(y1d, near_denominator),
+        _mm256_mul_pd(near_numerator, dy)), near_denominator), clip_near);
+    __m256d bounded_x2 = _mm256_blendv_pd(x2d, _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(x1d, far_denominator),
+        _mm256_mul_pd(far_numerator, dx)), far_denominator), clip_far);
+    __m256d bounded_y2 = _mm256_blendv_pd(y2d, _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(y1d, far_denominator),
+        _mm256_mul_pd(far_numerator, dy)), far_denominator), clip_far);
+    __m256d hit = _mm256_and_pd(_mm256_cmp_pd(_mm256_mul_pd(near_numerator, far_denominator),
+        _mm256_mul_pd(far_numerator, near_denominator), _CMP_LT_OQ),
+        _mm256_and_pd(_mm256_cmp_pd(near_numerator, near_denominator, _CMP_LT_OQ),
+            _mm256_cmp_pd(far_numerator, zero, _CMP_GT_OQ)));
+
+    // Vertical and horizontal lines are clamped to the region.
+    __m256d clamped_y1 = _mm256_max_pd(_mm256_min_pd(y1d, max_y), min_y);
+    __m256d clamped_y2 = _mm256_max_pd(_mm256_min_pd(y2d, max_y), min_y);
+    __m256d vertical_hit = _mm256_and_pd(
+        _mm256_and_pd(_mm256_cmp_pd(x1d, min_x, _CMP_GE_OQ), _mm256_cmp_pd(x1d, max_x, _CMP_LE_OQ)),
+        _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(y1d, y2d), max_y, _CMP_LE_OQ),
+            _mm256_cmp_pd(_mm256_max_pd(y1d, y2d), min_y, _CMP_GE_OQ)),
+            _mm256_cmp_pd(clamped_y1, clamped_y2, _CMP_NEQ_OQ)));
+    __m256d clamped_x1 = _mm256_max_pd(_mm256_min_pd(x1d, max_x), min_x);
+    __m256d clamped_x2 = _mm256_max_pd(_mm256_min_pd(x2d, max_x), min_x);
+    __m256d horizontal_hit = _mm256_and_pd(
+        _mm256_and_pd(_mm256_cmp_pd(y1d, min_y, _CMP_GE_OQ), _mm256_cmp_pd(y1d, max_y, _CMP_LE_OQ)),
+        _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(x1d, x2d), max_x, _CMP_LE_OQ),
+            _mm256_cmp_pd(_mm256_max_pd(x1d, x2d), min_x, _CMP_GE_OQ)),
+            _mm256_cmp_pd(clamped_x1, clamped_x2, _CMP_NEQ_OQ)));
+    __m256d horizontal = _mm256_andnot_pd(dx_zero, dy_zero);
+    bounded_x1 = _mm256_blendv_pd(_mm256_blendv_pd(bounded_x1, x1d, dx_zero), clamped_x1, horizontal);
+    bounded_x2 = _mm256_blendv_pd(_mm256_blendv_pd(bounded_x2, x2d, dx_zero), clamped_x2, horizontal);
+    bounded_y1 = _mm256_blendv_pd(_mm256_blendv_pd(bounded_y1, clamped_y1, dx_zero), y1d, horizontal);
+    bounded_y2 = _mm256_blendv_pd(_mm256_blendv_pd(bounded_y2, clamped_y2, dx_zero), y2d, horizontal);
+    hit = _mm256_blendv_pd(_mm256_blendv_pd(hit, vertical_hit, dx_zero), horizontal_hit, horizontal);
+
+    _mm_storeu_si128((__m128i *)out_x1, _mm256_cvttpd_epi32(bounded_x1));
+    _mm_storeu_si128((__m128i *)out_y1, _mm256_cvttpd_epi32(bounded_y1));
+    _mm_storeu_si128((__m128i *)out_x2, _mm256_cvttpd_epi32(bounded_x2));
+    _mm_storeu_si128((__m128i *)out_y2, _mm256_cvttpd_epi32(bounded_y2));
+    return (uint32_t)_mm256_movemask_pd(hit);
+}
+
+#endif
+
+#if defined(LINE_BOUND_BATCH_WIDTH)
+
+/// The largest magnitude of a coordinate for which line_bound_batch_lanes() is exact. The products of t
+/// numerators and denominators are then below 2^52, and the clipped coordinates are truncated correctly.
+#define LINE_BOUND_BATCH_EXACT_LIMIT (1 << 25)
+
+/// Tests whether a coordinate is within +-LINE_BOUND_BATCH_EXACT_LIMIT.
+static inline bool line_bound_batch_exact(int32_t v)
+{
+    return (uint32_t)v + LINE_BOUND_BATCH_EXACT_LIMIT <= 2u * LINE_BOUND_BATCH_EXACT_LIMIT;
+}
+
+/// Tests whether all LINE_BOUND_BATCH_WIDTH lines can be bounded exactly by line_bound_batch_lanes().
+static inline bool line_bound_batch_lanes_exact(const int32_t *x1, const int32_t *y1,
+    const int32_t *x2, const int32_t *y2)
+{
+    bool exact = true;
+    for (int32_t lane = 0; lane < LINE_BOUND_BATCH_WIDTH; lane++)
+    {
+        exact &= line_bound_batch_exact(x1[lane]) & line_bound_batch_exact(y1[lane]) &
+            line_bound_batch_exact(x2[lane]) & line_bound_batch_exact(y2[lane]);
+    }
+    return exact;
+}
+
+#endif
+
+void line_bound_inside_rect_batch(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    int32_t count, int32_t bounds_min_x, int32_t bounds_min_y, int32_t bounds_max_x, int32_t bounds_max_y,
+    uint32_t *out_hit_masks, int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2)
+{
+    if (count <= 0)
+        return;
+    memset(out_hit_masks, 0, sizeof(uint32_t) * (size_t)((count + 31) / 32));
+    int32_t i = 0;
+#if defined(__AVX512F__)
+    __m512d min_x = _mm512_set1_pd(bounds_min_x);
+    __m512d min_y = _mm512_set1_pd(bounds_min_y);
+    __m512d max_x = _mm512_set1_pd(bounds_max_x);
+    __m512d max_y = _mm512_set1_pd(bounds_max_y);
+#elif defined(__AVX2__)
+    __m256d min_x = _mm256_set1_pd(bounds_min_x);
+    __m256d min_y = _mm256_set1_pd(bounds_min_y);
+    __m256d max_x = _mm256_set1_pd(bounds_max_x);
+    __m256d max_y = _mm256_set1_pd(bounds_max_y);
+#endif
+#if defined(LINE_BOUND_BATCH_WIDTH)
+    // Groups of lines with a coordinate outside the exact range of doubles are bounded one by one instead.
+    bool region_exact = line_bound_batch_exact(bounds_min_x) && line_bound_batch_exact(bounds_min_y) &&
+        line_bound_batch_exact(bounds_max_x) && line_bound_batch_exact(bounds_max_y);
+    for (; region_exact && i + LINE_BOUND_BATCH_WIDTH <= count; i += LINE_BOUND_BATCH_WIDTH)
+    {
+        if (line_bound_batch_lanes_exact(x1 + i, y1 + i, x2 + i, y2 + i))
+        {
+            uint32_t hits = line_bound_batch_lanes(x1 + i, y1 + i, x2 + i, y2 + i, min_x, min_y, max_x, max_y,
+                out_x1 + i, out_y1 + i, out_x2 + i, out_y2 + i);
+            out_hit_masks[i / 32] |= hits << (i % 32);
+            continue;
+        }
+        for (int32_t j = i; j < i + LINE_BOUND_BATCH_WIDTH; j++)
+        {
+            if (line_bound_batch_line(x1[j], y1[j], x2[j], y2[j], bounds_min_x, bounds_min_y, bounds_max_x,
+                bounds_max_y, &out_x1[j], &out_y1[j], &out_x2[j], &out_y2[j]))
+                out_hit_masks[j / 32] |= (uint32_t)1 << (j % 32);
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        if (line_bound_batch_line(x1[i], y1[i], x2[i], y2[i], bounds_min_x, bounds_min_y, bounds_max_x, bounds_max_y,
+            &out_x1[i], &out_y1[i], &out_x2[i], &out_y2[i]))
+            out_hit_masks[i / 32] |= (uint32_t)1 << (i % 32);
+    }
+}
+
 bool line_extend_inside_rect(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
     int32_t bounds_min_x, int32_t bounds_min_y, int32_t bounds_max_x, int32_t bounds_max_y,
     int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2)
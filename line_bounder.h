@@ -25,6 +25,200 @@ bool line_bound_inside_rect(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
     int32_t bounds_min_x, int32_t bounds_min_y, int32_t bounds_max_x, int32_t bounds_max_y,
     int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2);
 
+/// Bounds many lines stored as arrays to one rectangle region, using SIMD instructions when available.
+/// @param x1 is an array of the 1st x points of the lines.
+/// @param y1 is an array of the 1st y points of the lines.
+/// @param x2 is an array of the 2nd x points of the lines.
+/// @param y2 is an array of the 2nd y points of the lines.
+/// @param count is the number of lines.
+/// @param box_min_x is the inclusive minimum x value to bound the lines within.
+/// @param box_min_y is the inclusive minimum y value to bound the lines within.
+/// @param box_min_y is the inclusive maximum x value to bound the lines within.
+/// @param box_max_y is the inclusive maximum y value to bound the lines within.
+/// @param out_hit_masks is an array of (count + 31) / 32 words. Bit (i % 32) of word (i / 32) is set
+/// if line i is inside the region, and cleared otherwise.
+/// @param out_x1 is an array to write the new x1 coordinates to.
+/// @param out_y1 is an array to write the new y1 coordinates to.
+/// @param out_x2 is an array to write the new x2 coordinates to.
+/// @param out_y2 is an array to write the new y2 coordinates to.
+/// @remarks Gives the same result as calling line_bound_inside_rect() for each line, computed without its
+/// overflow for large coordinates like line_bound_inside_rect64(). The output coordinates are only meaningful
+/// for lines whose hit bit is set.
+/// Lines with both endpoints inside the region, or both endpoints past the same side of it, are accepted or
+/// rejected without computing their intersection. When compiled with AVX2 (-mavx2) or AVX-512 (-mavx512f),
+/// 4 or 8 lines are bounded at once in double precision, which is exact while coordinates and the region
+/// are within +-2^25. Groups of lines outside that range are bounded one at a time with 64 bit integers, so
+/// the result doesn't depend on the build flags.
+void line_bound_inside_rect_batch(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    int32_t count, int32_t bounds_min_x, int32_t bounds_min_y, int32_t bounds_max_x, int32_t bounds_max_y,
+    uint32_t *out_hit_masks, int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2);
+
+/// Bounds a line with 64 bit coordinates to a rectangle region.
+/// @param x1 is the 1st x point of the line.
+/// @param y1 is the 1st y point of the line.
+/// @param x2 is the 2nd x point of the line.
+/// @param y2 is the 2nd y point of the line.
+/// @param box_min_x is the inclusive minimum x value to bound the line within.
+/// @param box_min_y is the inclusive minimum y value to bound the line within.
+/// @param box_min_y is the inclusive maximum x value to bound the line within.
+/// @param box_max_y is the inclusive maximum y value to bound the line within.
+/// @param out_x1 is a pointer to the new x1 coordinate after bounding.
+/// @param out_y1 is a pointer to the new y1 coordinate after bounding.
+/// @param out_x2 is a pointer to the new x2 coordinate after bounding.
+/// @param out_y2 is a pointer to the new y2 coordinate after bounding.
+/// @returns true if the line segment returned is inside the region, false otherwise.
+/// @remarks Gives the same result as line_bound_inside_rect(), but the products of coordinates and
+/// t denominators are computed with 128 bits, so they don't overflow for large coordinates.
+/// The coordinate differences must fit in an int64_t.
+bool line_bound_inside_rect64(int64_t x1, int64_t y1, int64_t x2, int64_t y2,
+    int64_t bounds_min_x, int64_t bounds_min_y, int64_t bounds_max_x, int64_t bounds_max_y,
+    int64_t *out_x1, int64_t *out_y1, int64_t *out_x2, int64_t *out_y2);
+
+/// Initializes a LineTraverser for the part of a line inside of a rectangle region.
+/// @param p_out_traverser is a pointer to write the traverser to.
+/// @param x1 is the 1st x point of the line.
+/// @param y1 is the 1st y point of the line.
+/// @param x2 is the 2nd x point of the line.
+/// @param y2 is the 2nd y point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param box_min_x is the inclusive minimum x value to bound the line within.
+/// @param box_min_y is the inclusive minimum y value to bound the line within.
+/// @param box_min_y is the inclusive maximum x value to bound the line within.
+/// @param box_max_y is the inclusive maximum y value to bound the line within.
+/// @returns true if part of the line is inside the region, false otherwise. Like line_bound_inside_rect(),
+/// a line which only touches the region at a single point is not inside it.
+/// @remarks Unlike traversing the rounded endpoints from line_bound_inside_rect(), the traverser keeps the slope
+/// of the original line, so it traverses exactly the grid squares of LineTraverser_init() that the line
+/// goes through while it is inside the region. See LineTraverser_init_range().
+bool line_bound_traverser_inside_rect(LineTraverser *p_out_traverser, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t bounds_min_x, int32_t bounds_min_y, int32_t bounds_max_x, int32_t bounds_max_y);
+
+/// Gets the parts of a line inside of any of several rectangle regions, as ranges of the line's parameter t.
+/// @param x1 is the 1st x point of the line.
+/// @param y1 is the 1st y point of the line.
+/// @param x2 is the 2nd x point of the line.
+/// @param y2 is the 2nd y point of the line.
+/// @param bounds_min_x is an array of the inclusive minimum x values of the regions.
+/// @param bounds_min_y is an array of the inclusive minimum y values of the regions.
+/// @param bounds_max_x is an array of the inclusive maximum x values of the regions.
+/// @param bounds_max_y is an array of the inclusive maximum y values of the regions.
+/// @param bounds_count is the number of regions.
+/// @param out_t_begin_numerators is an array of at least bounds_count numerators of where each range begins.
+/// @param out_t_begin_denominators is an array of at least bounds_count denominators of where each range begins.
+/// @param out_t_end_numerators is an array of at least bounds_count numerators of where each range ends.
+/// @param out_t_end_denominators is an array of at least bounds_count denominators of where each range ends.
+/// @returns the number of ranges written. The ranges are sorted by t and don't overlap or touch, because the
+/// ranges of overlapping regions are merged. Like line_bound_inside_rect(), a region which the line only touches
+/// at a single point adds no range.
+/// @remarks The slope of the line is analyzed once, rather than once per region.
+/// Each range can be traversed with LineTraverser_init_range().
+int32_t line_bound_inside_rects(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    const int32_t *bounds_min_x, const int32_t *bounds_min_y, const int32_t *bounds_max_x, const int32_t *bounds_max_y,
+    int32_t bounds_count, int64_t *out_t_begin_numerators, int64_t *out_t_begin_denominators,
+    int64_t *out_t_end_numerators, int64_t *out_t_end_denominators);
+
+/// Traverses the grid squares that a line goes through while it is inside of any of several rectangle regions.
+/// @param x1 is the 1st x point of the line.
+/// @param y1 is the 1st y point of the line.
+/// @param x2 is the 2nd x point of the line.
+/// @param y2 is the 2nd y point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param bounds_min_x is an array of the inclusive minimum x values of the regions.
+/// @param bounds_min_y is an array of the inclusive minimum y values of the regions.
+/// @param bounds_max_x is an array of the inclusive maximum x values of the regions.
+/// @param bounds_max_y is an array of the inclusive maximum y values of the regions.
+/// @param bounds_count is the number of regions.
+/// @param callback is called for each grid square, in order along the line.
+/// @param user_data is passed to the callback.
+/// @returns true if the line was traversed, false if memory for the ranges could not be allocated.
+/// @remarks Every grid square is given once, even when it is in several regions, or when the line leaves one
+/// region and enters another inside the same grid square. See line_bound_inside_rects().
+bool line_bound_traverse_inside_rects(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+    const int32_t *bounds_min_x, const int32_t *bounds_min_y, const int32_t *bounds_max_x, const int32_t *bounds_max_y,
+    int32_t bounds_count, LineTraverserCallback callback, void *user_data);
+
+/// A convex polygon prepared for bounding lines, with the inward normal and offset of each edge, so that a point p
+/// is inside of the polygon if normal_x[i] * p.x + normal_y[i] * p.y >= offset[i] for every edge i.
+/// The bounding box of the vertices is kept to reject lines without testing every edge.
+typedef struct
+{
+    int64_t *normal_x;
+    int64_t *normal_y;
+    int64_t *offset;
+    int32_t edge_count;
+    int32_t bounds_min_x;
+    int32_t bounds_min_y;
+    int32_t bounds_max_x;
+    int32_t bounds_max_y;
+} LineBoundPolygon;
+
+/// Prepares a convex polygon for bounding lines.
+/// @param p_polygon is a pointer to the polygon to initialize.
+/// @param x is an array of the x coordinates of the vertices, in order around the polygon.
+/// @param y is an array of the y coordinates of the vertices, in order around the polygon.
+/// @param vertex_count is the number of vertices.
+/// @returns true if the polygon was initialized, false if it has no area, is not convex (including self-intersecting
+/// polygons such as stars), or memory could not be allocated. The vertices may go in either direction, and may
+/// include collinear or repeated vertices.
+/// @remarks The bounding is exact while all coordinates of the polygon and lines are strictly between -2^30 and 2^30,
+/// which keeps the products of line_bound_inside_polygon() within 64 bits.
+/// LineBoundPolygon_destroy() must be called once the polygon is no longer used.
+bool LineBoundPolygon_init(LineBoundPolygon *p_polygon, const int32_t *x, const int32_t *y, int32_t vertex_count);
+
+/// Frees the memory of a LineBoundPolygon.
+/// @param p_polygon is a pointer to the polygon to free.
+void LineBoundPolygon_destroy(LineBoundPolygon *p_polygon);
+
+/// Gets the part of a line inside of a convex polygon, as a range of the line's parameter t.
+/// @param p_polygon is a pointer to the polygon to bound the line within.
+/// @param x1 is the 1st x point of the line.
+/// @param y1 is the 1st y point of the line.
+/// @param x2 is the 2nd x point of the line.
+/// @param y2 is the 2nd y point of the line.
+/// @param out_t_begin_numerator is a pointer to the numerator of where the part inside begins.
+/// @param out_t_begin_denominator is a pointer to the positive denominator of where the part inside begins.
+/// @param out_t_end_numerator is a pointer to the numerator of where the part inside ends.
+/// @param out_t_end_denominator is a pointer to the positive denominator of where the part inside ends.
+/// @returns true if part of the line is inside the polygon, false otherwise. Like line_bound_inside_rect(),
+/// a line which only touches the polygon at a single point is not inside it.
+/// @remarks The range can be traversed with LineTraverser_init_range().
+bool line_bound_inside_polygon(const LineBoundPolygon *p_polygon, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int64_t *out_t_begin_numerator, int64_t *out_t_begin_denominator,
+    int64_t *out_t_end_numerator, int64_t *out_t_end_denominator);
+
+/// Initializes a LineTraverser for the part of a line inside of a convex polygon.
+/// @param p_out_traverser is a pointer to write the traverser to.
+/// @param p_polygon is a pointer to the polygon to bound the line within.
+/// @param x1 is the 1st x point of the line.
+/// @param y1 is the 1st y point of the line.
+/// @param x2 is the 2nd x point of the line.
+/// @param y2 is the 2nd y point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @returns true if part of the line is inside the polygon, false otherwise.
+/// @remarks Like line_bound_traverser_inside_rect(), the traverser keeps the slope of the original line.
+bool line_bound_traverser_inside_polygon(LineTraverser *p_out_traverser, const LineBoundPolygon *p_polygon,
+    int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width);
+
+/// Gets the parts of many lines stored as arrays inside of one convex polygon.
+/// @param p_polygon is a pointer to the polygon to bound the lines within.
+/// @param x1 is an array of the 1st x points of the lines.
+/// @param y1 is an array of the 1st y points of the lines.
+/// @param x2 is an array of the 2nd x points of the lines.
+/// @param y2 is an array of the 2nd y points of the lines.
+/// @param count is the number of lines.
+/// @param out_hit_masks is an array of (count + 31) / 32 words. Bit (i % 32) of word (i / 32) is set
+/// if line i is inside the polygon, and cleared otherwise.
+/// @param out_t_begin_numerators is an array to write the numerators of where the parts inside begin to.
+/// @param out_t_begin_denominators is an array to write the denominators of where the parts inside begin to.
+/// @param out_t_end_numerators is an array to write the numerators of where the parts inside end to.
+/// @param out_t_end_denominators is an array to write the denominators of where the parts inside end to.
+/// @remarks Gives the same result as calling line_bound_inside_polygon() for each line. The ranges are only
+/// meaningful for lines whose hit bit is set.
+void line_bound_inside_polygon_batch(const LineBoundPolygon *p_polygon,
+    const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2, int32_t count,
+    uint32_t *out_hit_masks, int64_t *out_t_begin_numerators, int64_t *out_t_begin_denominators,
+    int64_t *out_t_end_numerators, int64_t *out_t_end_denominators);
+
 /// Extends a line to infinite length, and bounds to the inside of a rectangle.
 /// @param x1 is the 1st x point of the line.
 /// @param y1 is the 1st y point of the line.
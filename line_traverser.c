@@ -5,6 +5,7 @@
 
 #include "line_traverser.h"
 #include <math.h>
+#include <stdlib.h>
 
 #ifndef min
 #define min(a, b) (((a) < (b)) ? (a) : (b))
@@ -13,28 +14,161 @@
 #define max(a, b) (((a) > (b)) ? (a) : (b))
 #endif
 
-LineTraverser LineTraverser_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+__extension__ typedef __int128 line_traverser_int128;
+
+int64_t line_traverser_floor_div(int64_t numerator, int64_t denominator)
+{
+    int64_t quotient = numerator / denominator;
+    if ((numerator % denominator) != 0 && ((numerator < 0) != (denominator < 0)))
+        quotient--;
+    return quotient;
+}
+
+int64_t line_traverser_ceil_div(int64_t numerator, int64_t denominator)
+{
+    return -line_traverser_floor_div(-numerator, denominator);
+}
+
+int64_t line_traverser_gcd(int64_t a, int64_t b)
+{
+    while (b != 0)
+    {
+        int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/// Gets the inverse of a modulo m, where a and m are coprime and m > 0.
+int64_t line_traverser_mod_inverse(int64_t a, int64_t m)
+{
+    int64_t old_r = a % m, r = m;
+    int64_t old_s = 1, s = 0;
+    while (r != 0)
+    {
+        int64_t q = old_r / r;
+        int64_t t = old_r - q * r;
+        old_r = r;
+        r = t;
+        t = old_s - q * s;
+        old_s = s;
+        s = t;
+    }
+    old_s %= m;
+    return (old_s < 0) ? (old_s + m) : old_s;
+}
+
+// Every step of a traverser crosses the next x boundary, the next y boundary, or both at the same time.
+// Relative to the traverser's current state, x boundary i (counting from 0) is crossed at "time"
+// i * x_step_size - clockwiseness, and y boundary j is crossed at time j * y_step_size, where
+// x_step_size = -dx_clockwiseness and y_step_size = dy_clockwiseness. This is the same decision
+// LineTraverser_next() makes from the sign of the clockwiseness. The functions below use this to find the
+// traverser state after some number of steps without stepping through them.
+
+/// Counts the diagonal steps taken while crossing the first nx x boundaries and the first ny y boundaries.
+int64_t line_traverser_count_diagonals(const LineTraverser *p_traverser, int64_t nx, int64_t ny)
+{
+    if (nx <= 0 || ny <= 0)
+        return 0;
+    int64_t x_step_size = -p_traverser->dx_clockwiseness;
+    int64_t y_step_size = p_traverser->dy_clockwiseness;
+    int64_t clockwiseness = p_traverser->clockwiseness;
+    // A diagonal step happens for every i, j where i * x_step_size - j * y_step_size == clockwiseness.
+    int64_t g = line_traverser_gcd(x_step_size, y_step_size);
+    if ((clockwiseness % g) != 0)
+        return 0;
+    int64_t a = x_step_size / g;
+    int64_t b = y_step_size / g;
+    int64_t c = clockwiseness / g;
+    int64_t c_mod_b = c % b;
+    if (c_mod_b < 0)
+        c_mod_b += b;
+    int64_t i0 = (int64_t)(((line_traverser_int128)c_mod_b * line_traverser_mod_inverse(a, b)) % b);
+    int64_t j0 = (int64_t)(((line_traverser_int128)i0 * a - c) / b);
+    // Solutions are i = i0 + t * b, j = j0 + t * a. i0 is in [0, b), so i >= 0 when t >= 0.
+    int64_t t_min = max((int64_t)0, line_traverser_ceil_div(-j0, a));
+    int64_t t_max = min(line_traverser_floor_div(nx - 1 - i0, b), line_traverser_floor_div(ny - 1 - j0, a));
+    return max((int64_t)0, t_max - t_min + 1);
+}
+
+/// Counts the y boundaries crossed before reaching the first grid square after crossing nx x boundaries.
+int64_t line_traverser_y_steps_at_column(const LineTraverser *p_traverser, int64_t nx, int64_t max_ny)
+{
+    if (nx <= 0)
+        return 0;
+    int64_t time = (nx - 1) * -p_traverser->dx_clockwiseness - p_traverser->clockwiseness;
+    if (time < 0)
+        return 0;
+    return min(max_ny, time / p_traverser->dy_clockwiseness + 1);
+}
+
+/// Counts the x boundaries crossed before reaching the first grid square after crossing ny y boundaries.
+int64_t line_traverser_x_steps_at_row(const LineTraverser *p_traverser, int64_t ny, int64_t max_nx)
+{
+    if (ny <= 0)
+        return 0;
+    int64_t time = (ny - 1) * p_traverser->dy_clockwiseness + p_traverser->clockwiseness;
+    if (time < 0)
+        return 0;
+    return min(max_nx, time / -p_traverser->dx_clockwiseness + 1);
+}
+
+/// Gets the number of steps to reach the state that has crossed nx x boundaries and ny y boundaries.
+int64_t line_traverser_step_index(const LineTraverser *p_traverser, int64_t nx, int64_t ny)
+{
+    return nx + ny - line_traverser_count_diagonals(p_traverser, nx, ny);
+}
+
+/// Updates a traverser to the state after crossing nx x boundaries and ny y boundaries.
+void line_traverser_advance(LineTraverser *p_traverser, int64_t nx, int64_t ny)
+{
+    p_traverser->x += (int32_t)nx * p_traverser->dx_x;
+    p_traverser->y += (int32_t)ny * p_traverser->dy_y;
+    p_traverser->clockwiseness += nx * p_traverser->dx_clockwiseness + ny * p_traverser->dy_clockwiseness;
+}
+
+/// Divides by square_width, rounding towards zero like the / operator.
+/// If square_shift is not negative, square_width must be (1 << square_shift) and a shift is used instead.
+static inline int32_t line_traverser_div(int32_t value, int32_t square_width, int32_t square_shift)
+{
+    if (square_shift >= 0)
+        return (value + ((value >> 31) & (square_width - 1))) >> square_shift;
+    return value / square_width;
+}
+
+/// Gets the remainder of dividing by square_width, with the same sign as value like the % operator.
+/// If square_shift is not negative, square_width must be (1 << square_shift) and a mask is used instead.
+static inline int32_t line_traverser_mod(int32_t value, int32_t square_width, int32_t square_shift)
+{
+    if (square_shift >= 0)
+        return value - (int32_t)((uint32_t)line_traverser_div(value, square_width, square_shift) << square_shift);
+    return value % square_width;
+}
+
+static inline LineTraverser line_traverser_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t square_shift)
 {
     LineTraverser traverser;
     int dx = x2 - x1;
     int dy = y2 - y1;
     traverser.dx_x = (dx >= 0) ? 1 : -1;
     traverser.dy_y = (dy >= 0) ? 1 : -1;
-    int local_x = x1 % square_width;
-    int local_y = y1 % square_width;
+    int local_x = line_traverser_mod(x1, square_width, square_shift);
+    int local_y = line_traverser_mod(y1, square_width, square_shift);
     int x_dist = (dx >= 0) ? (square_width - local_x) : (local_x);
     int y_dist = (dy >= 0) ? (square_width - local_y) : (local_y);
     traverser.clockwiseness = (int64_t)abs(dx) * abs(y_dist) - (int64_t)abs(dy) * abs(x_dist);
     traverser.dx_clockwiseness = -(int64_t)abs(dy) * square_width;
     traverser.dy_clockwiseness = (int64_t)abs(dx) * square_width;
 
-    traverser.x = x1 / square_width;
-    traverser.y = y1 / square_width;
-    traverser.end_x = x2 / square_width;
-    traverser.end_y = y2 / square_width;
+    traverser.x = line_traverser_div(x1, square_width, square_shift);
+    traverser.y = line_traverser_div(y1, square_width, square_shift);
+    traverser.end_x = line_traverser_div(x2, square_width, square_shift);
+    traverser.end_y = line_traverser_div(y2, square_width, square_shift);
     if (dy < 0)
     {
-        if ((y1 % square_width) == 0)
+        if (local_y == 0)
         {
             traverser.y--;
             traverser.clockwiseness += traverser.dy_clockwiseness;
@@ -42,13 +176,13 @@ LineTraverser LineTraverser_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
     }
     else if (dy > 0)
     {
-        if ((y2 % square_width) == 0)
+        if (line_traverser_mod(y2, square_width, square_shift) == 0)
             traverser.end_y--;
     }
 
     if (dx < 0)
     {
-        if ((x1 % square_width) == 0)
+        if (local_x == 0)
         {
             traverser.x--;
             traverser.clockwiseness += traverser.dx_clockwiseness;
@@ -56,72 +190,509 @@ LineTraverser LineTraverser_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
     }
     else if (dx > 0)
     {
-        if ((x2 % square_width) == 0)
+        if (line_traverser_mod(x2, square_width, square_shift) == 0)
             traverser.end_x--;
     }
     return traverser;
 }
 
+/// Gets the shift that multiplies by square_width, or -1 if square_width is not a power of 2.
+static inline int32_t line_traverser_square_shift(int32_t square_width)
+{
+    if (square_width <= 0 || (square_width & (square_width - 1)) != 0)
+        return -1;
+    return __builtin_ctz((uint32_t)square_width);
+}
+
+LineTraverser LineTraverser_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    int32_t square_shift = line_traverser_square_shift(square_width);
+    if (square_shift >= 0)
+        return line_traverser_init(x1, y1, x2, y2, square_width, square_shift);
+    return line_traverser_init(x1, y1, x2, y2, square_width, -1);
+}
+
+LineTraverser LineTraverser_init_shift(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_shift)
+{
+    return line_traverser_init(x1, y1, x2, y2, (int32_t)1 << square_shift, square_shift);
+}
+
+/// Counts the grid boundaries that LineTraverser_next() crosses along one axis, from v1 to v2,
+/// up to the parameter t = t_numerator / t_denominator. Boundaries crossed exactly at t are counted if inclusive.
+int64_t line_traverser_crossings_at(int32_t v1, int32_t v2, int32_t square_width,
+    int64_t t_numerator, int64_t t_denominator, bool inclusive)
+{
+    int64_t dv = (int64_t)v2 - v1;
+    if (dv == 0)
+        return 0;
+    // Same distance to the first boundary as LineTraverser_init(), which already steps back over a boundary
+    // the line starts on when going in the negative direction.
+    int32_t local_v = line_traverser_mod(v1, square_width, -1);
+    int64_t dist = llabs((dv >= 0) ? ((int64_t)square_width - local_v) : local_v);
+    if (dv < 0 && local_v == 0)
+        dist = square_width;
+    // Boundary k >= 1 is crossed at t = (dist + (k - 1) * square_width) / |dv|.
+    line_traverser_int128 reach = (line_traverser_int128)t_numerator * llabs(dv) - (inclusive ? 0 : 1);
+    line_traverser_int128 first = (line_traverser_int128)t_denominator * dist;
+    if (reach < first)
+        return 0;
+    return (int64_t)((reach - first) / ((line_traverser_int128)t_denominator * square_width)) + 1;
+}
+
+bool LineTraverser_init_range(LineTraverser *p_out_traverser, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int64_t t_begin_numerator, int64_t t_begin_denominator,
+    int64_t t_end_numerator, int64_t t_end_denominator)
+{
+    if ((line_traverser_int128)t_end_numerator * t_begin_denominator <
+        (line_traverser_int128)t_begin_numerator * t_end_denominator)
+        return false;
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t max_nx = (int64_t)(traverser.end_x - traverser.x) * traverser.dx_x;
+    int64_t max_ny = (int64_t)(traverser.end_y - traverser.y) * traverser.dy_y;
+    int64_t begin_nx = min(line_traverser_crossings_at(x1, x2, square_width,
+        t_begin_numerator, t_begin_denominator, true), max_nx);
+    int64_t begin_ny = min(line_traverser_crossings_at(y1, y2, square_width,
+        t_begin_numerator, t_begin_denominator, true), max_ny);
+    int64_t end_nx = min(line_traverser_crossings_at(x1, x2, square_width,
+        t_end_numerator, t_end_denominator, false), max_nx);
+    int64_t end_ny = min(line_traverser_crossings_at(y1, y2, square_width,
+        t_end_numerator, t_end_denominator, false), max_ny);
+    if (begin_nx > end_nx || begin_ny > end_ny)
+        return false;
+
+    traverser.end_x = traverser.x + (int32_t)end_nx * traverser.dx_x;
+    traverser.end_y = traverser.y + (int32_t)end_ny * traverser.dy_y;
+    line_traverser_advance(&traverser, begin_nx, begin_ny);
+    *p_out_traverser = traverser;
+    return true;
+}
+
+void LineTraverser_end_where_reached(LineTraverser *p_traverser, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width)
+{
+    // A boundary crossed exactly at the end of the line is not stepped over, like the end grid square of
+    // LineTraverser_init().
+    p_traverser->end_x = p_traverser->x + (int32_t)line_traverser_crossings_at(x1, x2, square_width, 1, 1, false) *
+        p_traverser->dx_x;
+    p_traverser->end_y = p_traverser->y + (int32_t)line_traverser_crossings_at(y1, y2, square_width, 1, 1, false) *
+        p_traverser->dy_y;
+}
+
 bool LineTraverser_is_end(const LineTraverser *p_traverser)
 {
-    return p_traverser->x == p_traverser->end_x &&
-        p_traverser->y == p_traverser->end_y;
+    return line_traverser_is_end_inline(p_traverser);
 }
 
 void LineTraverser_next(LineTraverser *p_traverser)
 {
-    int old_clockwiseness = p_traverser->clockwiseness;
+    line_traverser_next_inline(p_traverser);
+}
+
+void LineTraverser_skip_row(LineTraverser *p_traverser)
+{
+    // x is stepped alone for as long as the clockwiseness stays positive.
+    int64_t steps = 0;
+    if (p_traverser->y == p_traverser->end_y)
+        steps = (int64_t)(p_traverser->end_x - p_traverser->x) * p_traverser->dx_x;
+    else if (p_traverser->clockwiseness > 0)
+        steps = (p_traverser->clockwiseness - 1) / -p_traverser->dx_clockwiseness + 1;
+    p_traverser->x += (int32_t)steps * p_traverser->dx_x;
+    p_traverser->clockwiseness += steps * p_traverser->dx_clockwiseness;
+}
+
+void LineTraverser_skip_column(LineTraverser *p_traverser)
+{
+    // y is stepped alone for as long as the clockwiseness stays negative.
+    int64_t steps = 0;
+    if (p_traverser->x == p_traverser->end_x)
+        steps = (int64_t)(p_traverser->end_y - p_traverser->y) * p_traverser->dy_y;
+    else if (p_traverser->clockwiseness < 0)
+        steps = (-p_traverser->clockwiseness - 1) / p_traverser->dy_clockwiseness + 1;
+    p_traverser->y += (int32_t)steps * p_traverser->dy_y;
+    p_traverser->clockwiseness += steps * p_traverser->dy_clockwiseness;
+}
+
+void LineTraverser_skip_span(LineTraverser *p_traverser)
+{
+    if (-p_traverser->dx_clockwiseness <= p_traverser->dy_clockwiseness)
+        LineTraverser_skip_row(p_traverser);
+    else
+        LineTraverser_skip_column(p_traverser);
+}
+
+void LineTraverser_get_point(const LineTraverser *p_traverser, int32_t *out_x, int32_t *out_y)
+{
+    *out_x = p_traverser->x;
+    *out_y = p_traverser->y;
+}
+
+bool LineTraverser_seek(LineTraverser *p_traverser, int64_t steps)
+{
+    int64_t max_nx = (int64_t)(p_traverser->end_x - p_traverser->x) * p_traverser->dx_x;
+    int64_t max_ny = (int64_t)(p_traverser->end_y - p_traverser->y) * p_traverser->dy_y;
+    if (steps < 0 || steps > line_traverser_step_index(p_traverser, max_nx, max_ny))
+        return false;
+    if (max_nx == 0)
+    {
+        line_traverser_advance(p_traverser, 0, steps);
+        return true;
+    }
+    if (max_ny == 0)
+    {
+        line_traverser_advance(p_traverser, steps, 0);
+        return true;
+    }
+    // Find the last column which is entered at or before the step, the rest of the steps only move y.
+    int64_t low = 0, high = max_nx;
+    while (low < high)
+    {
+        int64_t mid = low + (high - low + 1) / 2;
+        int64_t ny = line_traverser_y_steps_at_column(p_traverser, mid, max_ny);
+        if (line_traverser_step_index(p_traverser, mid, ny) <= steps)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    int64_t ny = line_traverser_y_steps_at_column(p_traverser, low, max_ny);
+    ny += steps - line_traverser_step_index(p_traverser, low, ny);
+    line_traverser_advance(p_traverser, low, ny);
+    return true;
+}
+
+int64_t LineTraverser_seek_column(LineTraverser *p_traverser, int32_t x)
+{
+    int64_t max_nx = (int64_t)(p_traverser->end_x - p_traverser->x) * p_traverser->dx_x;
+    int64_t max_ny = (int64_t)(p_traverser->end_y - p_traverser->y) * p_traverser->dy_y;
+    int64_t nx = ((int64_t)x - p_traverser->x) * p_traverser->dx_x;
+    if (nx < 0 || nx > max_nx)
+        return -1;
+    int64_t ny = line_traverser_y_steps_at_column(p_traverser, nx, max_ny);
+    int64_t steps = line_traverser_step_index(p_traverser, nx, ny);
+    line_traverser_advance(p_traverser, nx, ny);
+    return steps;
+}
+
+int64_t LineTraverser_seek_row(LineTraverser *p_traverser, int32_t y)
+{
+    int64_t max_nx = (int64_t)(p_traverser->end_x - p_traverser->x) * p_traverser->dx_x;
+    int64_t max_ny = (int64_t)(p_traverser->end_y - p_traverser->y) * p_traverser->dy_y;
+    int64_t ny = ((int64_t)y - p_traverser->y) * p_traverser->dy_y;
+    if (ny < 0 || ny > max_ny)
+        return -1;
+    int64_t nx = line_traverser_x_steps_at_row(p_traverser, ny, max_nx);
+    int64_t steps = line_traverser_step_index(p_traverser, nx, ny);
+    line_traverser_advance(p_traverser, nx, ny);
+    return steps;
+}
+
+bool LineTraverser_next_points(LineTraverser *p_traverser, int32_t *out_x, int32_t *out_y,
+    int32_t max_count, int32_t *out_count)
+{
+    int32_t count = 0;
+    bool is_end = false;
+    while (count < max_count)
+    {
+        LineTraverser span_end = *p_traverser;
+        LineTraverser_skip_span(&span_end);
+        int32_t x = p_traverser->x;
+        int32_t y = p_traverser->y;
+        int32_t step_x = (span_end.x != x) ? p_traverser->dx_x : 0;
+        int32_t step_y = (span_end.y != y) ? p_traverser->dy_y : 0;
+        int32_t span_length = abs(span_end.x - x) + abs(span_end.y - y) + 1;
+        int32_t write_count = min(span_length, max_count - count);
+        for (int32_t i = 0; i < write_count; i++)
+        {
+            out_x[count + i] = x + i * step_x;
+            out_y[count + i] = y + i * step_y;
+        }
+        count += write_count;
+        if (write_count < span_length)
+        {
+            // The buffer is full in the middle of a span, stop on the first square that wasn't written.
+            p_traverser->x += write_count * step_x;
+            p_traverser->y += write_count * step_y;
+            if (step_x != 0)
+                p_traverser->clockwiseness += write_count * p_traverser->dx_clockwiseness;
+            else
+                p_traverser->clockwiseness += write_count * p_traverser->dy_clockwiseness;
+            break;
+        }
+        *p_traverser = span_end;
+        if (LineTraverser_is_end(p_traverser))
+        {
+            is_end = true;
+            break;
+        }
+        LineTraverser_next(p_traverser);
+    }
+    *out_count = count;
+    return is_end;
+}
+
+int64_t LineTraverser_count_remaining(const LineTraverser *p_traverser)
+{
+    int64_t nx = (int64_t)(p_traverser->end_x - p_traverser->x) * p_traverser->dx_x;
+    int64_t ny = (int64_t)(p_traverser->end_y - p_traverser->y) * p_traverser->dy_y;
+    return line_traverser_step_index(p_traverser, nx, ny) + 1;
+}
+
+int64_t LineTraverser_count_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    return LineTraverser_count_remaining(&traverser);
+}
+
+int64_t LineTraverser_count_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    int64_t count = LineTraverser_count_include_endpoints(x1, y1, x2, y2, square_width);
+    return max(count - 2, (int64_t)0);
+}
+
+/// Gets the range of step indices of a traverser whose grid squares lie inside of a rectangle.
+/// Returns false if no grid square of the line is inside the rectangle.
+bool line_traverser_rect_step_range(const LineTraverser *p_traverser,
+    int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y,
+    int64_t *out_first_step, int64_t *out_last_step)
+{
+    int64_t nx = (int64_t)(p_traverser->end_x - p_traverser->x) * p_traverser->dx_x;
+    int64_t ny = (int64_t)(p_traverser->end_y - p_traverser->y) * p_traverser->dy_y;
+    int64_t last_step = line_traverser_step_index(p_traverser, nx, ny);
+
+    // Convert the rectangle to a range of x and y boundary crossings.
+    int64_t nx_min, nx_max, ny_min, ny_max;
+    if (p_traverser->dx_x > 0)
+    {
+        nx_min = (int64_t)rect_min_x - p_traverser->x;
+        nx_max = (int64_t)rect_max_x - p_traverser->x;
+    }
+    else
+    {
+        nx_min = (int64_t)p_traverser->x - rect_max_x;
+        nx_max = (int64_t)p_traverser->x - rect_min_x;
+    }
+    if (p_traverser->dy_y > 0)
+    {
+        ny_min = (int64_t)rect_min_y - p_traverser->y;
+        ny_max = (int64_t)rect_max_y - p_traverser->y;
+    }
+    else
+    {
+        ny_min = (int64_t)p_traverser->y - rect_max_y;
+        ny_max = (int64_t)p_traverser->y - rect_min_y;
+    }
+    nx_min = max(nx_min, (int64_t)0);
+    nx_max = min(nx_max, nx);
+    ny_min = max(ny_min, (int64_t)0);
+    ny_max = min(ny_max, ny);
+    if (nx_min > nx_max || ny_min > ny_max)
+        return false;
+
+    int64_t first_step_x = line_traverser_step_index(p_traverser, nx_min,
+        line_traverser_y_steps_at_column(p_traverser, nx_min, ny));
+    int64_t first_step_y = line_traverser_step_index(p_traverser,
+        line_traverser_x_steps_at_row(p_traverser, ny_min, nx), ny_min);
+    int64_t last_step_x = last_step;
+    if (nx_max < nx)
+    {
+        last_step_x = line_traverser_step_index(p_traverser, nx_max + 1,
+            line_traverser_y_steps_at_column(p_traverser, nx_max + 1, ny)) - 1;
+    }
+    int64_t last_step_y = last_step;
+    if (ny_max < ny)
+    {
+        last_step_y = line_traverser_step_index(p_traverser,
+            line_traverser_x_steps_at_row(p_traverser, ny_max + 1, nx), ny_max + 1) - 1;
+    }
+    *out_first_step = max(first_step_x, first_step_y);
+    *out_last_step = min(last_step_x, last_step_y);
+    return *out_first_step <= *out_last_step;
+}
+
+bool LineTraverser_clip_to_rect(LineTraverser *p_traverser,
+    int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y)
+{
+    int64_t first_step, last_step;
+    if (!line_traverser_rect_step_range(p_traverser, rect_min_x, rect_min_y, rect_max_x, rect_max_y,
+        &first_step, &last_step))
+        return false;
+    LineTraverser_seek(p_traverser, first_step);
+    LineTraverser end = *p_traverser;
+    LineTraverser_seek(&end, last_step - first_step);
+    p_traverser->end_x = end.x;
+    p_traverser->end_y = end.y;
+    return true;
+}
+
+int64_t LineTraverser_count_inside_rect_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t first_step, last_step;
+    if (!line_traverser_rect_step_range(&traverser, rect_min_x, rect_min_y, rect_max_x, rect_max_y,
+        &first_step, &last_step))
+        return 0;
+    return last_step - first_step + 1;
+}
+
+int64_t LineTraverser_count_inside_rect_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t first_step, last_step;
+    if (!line_traverser_rect_step_range(&traverser, rect_min_x, rect_min_y, rect_max_x, rect_max_y,
+        &first_step, &last_step))
+        return 0;
+    int64_t end_step = LineTraverser_count_remaining(&traverser) - 1;
+    first_step = max(first_step, (int64_t)1);
+    last_step = min(last_step, end_step - 1);
+    return max(last_step - first_step + 1, (int64_t)0);
+}
+
+bool LineTraverserCompact_fits(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    int64_t abs_dx = llabs((int64_t)x2 - x1);
+    int64_t abs_dy = llabs((int64_t)y2 - y1);
+    // The clockwiseness stays within (|dx| + |dy|) * square_width of 0, and gets a delta added to it.
+    // This is divided instead of multiplied, so it can't overflow for large square widths.
+    return abs_dx + abs_dy <= INT32_MAX / 2 / square_width;
+}
+
+/// The bits of LineTraverserCompact.remaining which tell whether x and y are mirrored.
+#define LINE_TRAVERSER_COMPACT_MIRROR_X 1u
+#define LINE_TRAVERSER_COMPACT_MIRROR_Y 2u
+/// The amount LineTraverserCompact.remaining goes down by for every step of an axis.
+#define LINE_TRAVERSER_COMPACT_STEP 4u
+
+static inline LineTraverserCompact line_traverser_compact_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t square_shift)
+{
+    // Same as line_traverser_init(), in 32 bits.
+    LineTraverserCompact traverser;
+    int32_t dx = x2 - x1;
+    int32_t dy = y2 - y1;
+    int32_t local_x = line_traverser_mod(x1, square_width, square_shift);
+    int32_t local_y = line_traverser_mod(y1, square_width, square_shift);
+    int32_t x_dist = (dx >= 0) ? (square_width - local_x) : (local_x);
+    int32_t y_dist = (dy >= 0) ? (square_width - local_y) : (local_y);
+    traverser.clockwiseness = abs(dx) * abs(y_dist) - abs(dy) * abs(x_dist);
+    traverser.dx_clockwiseness = -abs(dy) * square_width;
+    traverser.dy_clockwiseness = abs(dx) * square_width;
+
+    int32_t x = line_traverser_div(x1, square_width, square_shift);
+    int32_t y = line_traverser_div(y1, square_width, square_shift);
+    int32_t end_x = line_traverser_div(x2, square_width, square_shift);
+    int32_t end_y = line_traverser_div(y2, square_width, square_shift);
+    if (dy < 0)
+    {
+        if (local_y == 0)
+        {
+            y--;
+            traverser.clockwiseness += traverser.dy_clockwiseness;
+        }
+    }
+    else if (dy > 0)
+    {
+        if (line_traverser_mod(y2, square_width, square_shift) == 0)
+            end_y--;
+    }
+
+    if (dx < 0)
+    {
+        if (local_x == 0)
+        {
+            x--;
+            traverser.clockwiseness += traverser.dx_clockwiseness;
+        }
+    }
+    else if (dx > 0)
+    {
+        if (line_traverser_mod(x2, square_width, square_shift) == 0)
+            end_x--;
+    }
+
+    // |dx| + |dy| < 2^30, and each axis crosses at most |dv| boundaries, or |dv| / 2 + 1 when square_width >= 2,
+    // so the distance is less than 2^30 and fits in the bits above the mirror bits.
+    uint32_t distance = (uint32_t)abs(end_x - x) + (uint32_t)abs(end_y - y);
+    traverser.remaining = (distance * LINE_TRAVERSER_COMPACT_STEP) |
+        ((dx < 0) ? LINE_TRAVERSER_COMPACT_MIRROR_X : 0) | ((dy < 0) ? LINE_TRAVERSER_COMPACT_MIRROR_Y : 0);
+    traverser.x = (dx < 0) ? ~x : x;
+    traverser.y = (dy < 0) ? ~y : y;
+    return traverser;
+}
+
+LineTraverserCompact LineTraverserCompact_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    int32_t square_shift = line_traverser_square_shift(square_width);
+    if (square_shift >= 0)
+        return line_traverser_compact_init(x1, y1, x2, y2, square_width, square_shift);
+    return line_traverser_compact_init(x1, y1, x2, y2, square_width, -1);
+}
+
+bool LineTraverserCompact_is_end(const LineTraverserCompact *p_traverser)
+{
+    return p_traverser->remaining < LINE_TRAVERSER_COMPACT_STEP;
+}
+
+void LineTraverserCompact_get_point(const LineTraverserCompact *p_traverser, int32_t *out_x, int32_t *out_y)
+{
+    // All bits set for a mirrored axis, and none otherwise.
+    int32_t mirror_x = -(int32_t)(p_traverser->remaining & LINE_TRAVERSER_COMPACT_MIRROR_X);
+    int32_t mirror_y = -(int32_t)((p_traverser->remaining & LINE_TRAVERSER_COMPACT_MIRROR_Y) >> 1);
+    *out_x = p_traverser->x ^ mirror_x;
+    *out_y = p_traverser->y ^ mirror_y;
+}
+
+void LineTraverserCompact_next(LineTraverserCompact *p_traverser)
+{
+    int32_t old_clockwiseness = p_traverser->clockwiseness;
     if (old_clockwiseness >= 0)
     {
-        p_traverser->x += p_traverser->dx_x;
+        p_traverser->x++;
         p_traverser->clockwiseness += p_traverser->dx_clockwiseness;
+        p_traverser->remaining -= LINE_TRAVERSER_COMPACT_STEP;
     }
     if (old_clockwiseness <= 0)
     {
-        p_traverser->y += p_traverser->dy_y;
+        p_traverser->y++;
         p_traverser->clockwiseness += p_traverser->dy_clockwiseness;
+        p_traverser->remaining -= LINE_TRAVERSER_COMPACT_STEP;
     }
 }
 
-void LineTraverser_get_point(const LineTraverser *p_traverser, int32_t *out_x, int32_t *out_y)
-{
-    *out_x = p_traverser->x;
-    *out_y = p_traverser->y;
-}
-
-void LineTraverser_get_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+static inline void line_traverser_get_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t square_shift,
     int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2)
 {
     int32_t dx = x2 - x1;
     int32_t dy = y2 - y1;
-    int32_t endpoint1_x = x1 / square_width;
-    int32_t endpoint1_y = y1 / square_width;
-    int32_t endpoint2_x = x2 / square_width;
-    int32_t endpoint2_y = y2 / square_width;
+    int32_t endpoint1_x = line_traverser_div(x1, square_width, square_shift);
+    int32_t endpoint1_y = line_traverser_div(y1, square_width, square_shift);
+    int32_t endpoint2_x = line_traverser_div(x2, square_width, square_shift);
+    int32_t endpoint2_y = line_traverser_div(y2, square_width, square_shift);
 
     if (dy < 0)
     {
-        if ((y1 % square_width) == 0)
+        if (line_traverser_mod(y1, square_width, square_shift) == 0)
         {
             endpoint1_y--;
         }
     }
     else if (dy > 0)
     {
-        if ((y2 % square_width) == 0)
+        if (line_traverser_mod(y2, square_width, square_shift) == 0)
             endpoint2_y--;
     }
 
     if (dx < 0)
     {
-        if ((x1 % square_width) == 0)
+        if (line_traverser_mod(x1, square_width, square_shift) == 0)
         {
             endpoint1_x--;
         }
     }
     else if (dx > 0)
     {
-        if ((x2 % square_width) == 0)
+        if (line_traverser_mod(x2, square_width, square_shift) == 0)
             endpoint2_x--;
     }
 
@@ -131,10 +702,33 @@ void LineTraverser_get_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
     *out_y2 = endpoint2_y;
 }
 
+void LineTraverser_get_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+    int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2)
+{
+    int32_t square_shift = line_traverser_square_shift(square_width);
+    if (square_shift >= 0)
+        line_traverser_get_endpoints(x1, y1, x2, y2, square_width, square_shift, out_x1, out_y1, out_x2, out_y2);
+    else
+        line_traverser_get_endpoints(x1, y1, x2, y2, square_width, -1, out_x1, out_y1, out_x2, out_y2);
+}
 
 void LineTraverser_traverse_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width, 
     LineTraverserCallback callback, void *user_data)
 {
+    if (LineTraverserCompact_fits(x1, y1, x2, y2, square_width))
+    {
+        LineTraverserCompact traverser = LineTraverserCompact_init(x1, y1, x2, y2, square_width);
+        while (true)
+        {
+            int32_t x, y;
+            LineTraverserCompact_get_point(&traverser, &x, &y);
+            callback(x, y, user_data);
+            if (LineTraverserCompact_is_end(&traverser))
+                break;
+            LineTraverserCompact_next(&traverser);
+        }
+        return;
+    }
     LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
     while (true)
     {
@@ -150,6 +744,22 @@ void LineTraverser_traverse_include_endpoints(int32_t x1, int32_t y1, int32_t x2
 void LineTraverser_traverse_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width, 
     LineTraverserCallback callback, void *user_data)
 {
+    if (LineTraverserCompact_fits(x1, y1, x2, y2, square_width))
+    {
+        LineTraverserCompact traverser = LineTraverserCompact_init(x1, y1, x2, y2, square_width);
+        if (LineTraverserCompact_is_end(&traverser))
+            return;
+        while (true)
+        {
+            LineTraverserCompact_next(&traverser);
+            if (LineTraverserCompact_is_end(&traverser))
+                break;
+            int32_t x, y;
+            LineTraverserCompact_get_point(&traverser, &x, &y);
+            callback(x, y, user_data);
+        }
+        return;
+    }
     LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
     if (LineTraverser_is_end(&traverser))
         return;
@@ -163,3 +773,214 @@ void LineTraverser_traverse_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2
         callback(x, y, user_data);
     }
 }
+
+void LineTraverser_traverse_spans_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserSpanCallback callback, void *user_data)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int32_t span_x1, span_y1, span_x2, span_y2;
+        LineTraverser_get_point(&traverser, &span_x1, &span_y1);
+        LineTraverser_skip_span(&traverser);
+        LineTraverser_get_point(&traverser, &span_x2, &span_y2);
+        callback(span_x1, span_y1, span_x2, span_y2, user_data);
+        if (LineTraverser_is_end(&traverser))
+            break;
+        LineTraverser_next(&traverser);
+    }
+}
+
+void LineTraverser_traverse_spans_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserSpanCallback callback, void *user_data)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    if (LineTraverser_is_end(&traverser))
+        return;
+    LineTraverser_next(&traverser);
+    while (true)
+    {
+        int32_t span_x1, span_y1, span_x2, span_y2;
+        LineTraverser_get_point(&traverser, &span_x1, &span_y1);
+        LineTraverser_skip_span(&traverser);
+        LineTraverser_get_point(&traverser, &span_x2, &span_y2);
+        if (LineTraverser_is_end(&traverser))
+        {
+            // Drop the last grid square from the final span.
+            if (span_y1 == span_y2 && span_x1 != span_x2)
+                callback(span_x1, span_y1, span_x2 - traverser.dx_x, span_y2, user_data);
+            else if (span_y1 != span_y2)
+                callback(span_x1, span_y1, span_x2, span_y2 - traverser.dy_y, user_data);
+            break;
+        }
+        callback(span_x1, span_y1, span_x2, span_y2, user_data);
+        LineTraverser_next(&traverser);
+    }
+}
+
+void LineTraverser_traverse_rows_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserRowCallback callback, void *user_data)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int32_t row_x1 = traverser.x;
+        LineTraverser_skip_row(&traverser);
+        int32_t row_x2 = traverser.x;
+        callback(traverser.y, min(row_x1, row_x2), max(row_x1, row_x2), user_data);
+        if (LineTraverser_is_end(&traverser))
+            break;
+        LineTraverser_next(&traverser);
+    }
+}
+
+void LineTraverser_traverse_rows_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserRowCallback callback, void *user_data)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    if (LineTraverser_is_end(&traverser))
+        return;
+    LineTraverser_next(&traverser);
+    while (true)
+    {
+        int32_t row_x1 = traverser.x;
+        LineTraverser_skip_row(&traverser);
+        int32_t row_x2 = traverser.x;
+        if (LineTraverser_is_end(&traverser))
+        {
+            // Drop the last grid square from the final row.
+            if (row_x1 != row_x2)
+            {
+                row_x2 -= traverser.dx_x;
+                callback(traverser.y, min(row_x1, row_x2), max(row_x1, row_x2), user_data);
+            }
+            break;
+        }
+        callback(traverser.y, min(row_x1, row_x2), max(row_x1, row_x2), user_data);
+        LineTraverser_next(&traverser);
+    }
+}
+
+bool LineTraverser_traverse_until_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserVisitor visitor, void *user_data,
+    int64_t *out_count, int32_t *out_x, int32_t *out_y)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t count = 0;
+    bool stopped = false;
+    while (true)
+    {
+        count++;
+        if (!visitor(traverser.x, traverser.y, user_data))
+        {
+            stopped = true;
+            break;
+        }
+        if (LineTraverser_is_end(&traverser))
+            break;
+        LineTraverser_next(&traverser);
+    }
+    *out_count = count;
+    *out_x = traverser.x;
+    *out_y = traverser.y;
+    return stopped;
+}
+
+bool LineTraverser_traverse_until_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserVisitor visitor, void *user_data,
+    int64_t *out_count, int32_t *out_x, int32_t *out_y)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t count = 0;
+    bool stopped = false;
+    if (!LineTraverser_is_end(&traverser))
+    {
+        int32_t last_x = traverser.x;
+        int32_t last_y = traverser.y;
+        while (true)
+        {
+            LineTraverser_next(&traverser);
+            if (LineTraverser_is_end(&traverser))
+                break;
+            count++;
+            last_x = traverser.x;
+            last_y = traverser.y;
+            if (!visitor(traverser.x, traverser.y, user_data))
+            {
+                stopped = true;
+                break;
+            }
+        }
+        if (count > 0)
+        {
+            *out_x = last_x;
+            *out_y = last_y;
+        }
+    }
+    *out_count = count;
+    return stopped;
+}
+
+/// Traverses a line like LineTraverser_traverse_include_endpoints(), also calculating the parameter t where the line
+/// enters and exits every grid square. If include_endpoints is false, the first and last grid squares are skipped.
+void line_traverser_traverse_parametric(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+    bool include_endpoints, LineTraverserParametricCallback callback, void *user_data)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t abs_dx = abs(x2 - x1);
+    int64_t abs_dy = abs(y2 - y1);
+    // t = (distance along x) / |dx| = (distance along y) / |dy|, written over the common denominator |dx| * |dy|.
+    // An axis which doesn't move never ends a grid square, so its delta is treated as 1 to keep the other axis exact.
+    int64_t t_x_scale = max(abs_dy, (int64_t)1);
+    int64_t t_y_scale = max(abs_dx, (int64_t)1);
+    int64_t t_denominator = t_x_scale * t_y_scale;
+    int64_t x_dist = (traverser.dx_x > 0) ? ((int64_t)(traverser.x + 1) * square_width - x1) :
+        ((int64_t)x1 - (int64_t)traverser.x * square_width);
+    int64_t y_dist = (traverser.dy_y > 0) ? ((int64_t)(traverser.y + 1) * square_width - y1) :
+        ((int64_t)y1 - (int64_t)traverser.y * square_width);
+    int64_t t_x = x_dist * t_x_scale;
+    int64_t t_y = y_dist * t_y_scale;
+    int64_t t_x_step = (int64_t)square_width * t_x_scale;
+    int64_t t_y_step = (int64_t)square_width * t_y_scale;
+
+    int64_t t_enter = 0;
+    bool is_first = true;
+    while (true)
+    {
+        bool is_end = LineTraverser_is_end(&traverser);
+        int64_t t_exit = t_denominator;
+        if (!is_end)
+        {
+            if (abs_dx != 0)
+                t_exit = min(t_exit, t_x);
+            if (abs_dy != 0)
+                t_exit = min(t_exit, t_y);
+            t_exit = max(t_exit, t_enter);
+        }
+        if (include_endpoints || (!is_first && !is_end))
+            callback(traverser.x, traverser.y, t_enter, t_exit, t_denominator, user_data);
+        if (is_end)
+            break;
+        int32_t old_x = traverser.x;
+        int32_t old_y = traverser.y;
+        LineTraverser_next(&traverser);
+        if (traverser.x != old_x)
+            t_x += t_x_step;
+        if (traverser.y != old_y)
+            t_y += t_y_step;
+        t_enter = t_exit;
+        is_first = false;
+    }
+}
+
+void LineTraverser_traverse_parametric_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserParametricCallback callback, void *user_data)
+{
+    line_traverser_traverse_parametric(x1, y1, x2, y2, square_width, true, callback, user_data);
+}
+
+void LineTraverser_traverse_parametric_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserParametricCallback callback, void *user_data)
+{
+    line_traverser_traverse_parametric(x1, y1, x2, y2, square_width, false, callback, user_data);
+}
@@ -19,6 +19,20 @@ typedef struct
     int32_t end_x, end_y;
 } LineTraverser;
 
+/// Compact version of LineTraverser for lines where LineTraverserCompact_fits() is true.
+/// The clockwiseness and its deltas fit in 32 bits, and are stepped like LineTraverser_next().
+/// x and y are mirrored, by inverting their bits, for axes that go in the negative direction, so that stepping
+/// always adds 1 to them. The lowest 2 bits of remaining tell which of x and y are mirrored, and the rest of it
+/// is the Manhattan distance in grid squares to the end of the line, which every step of an axis reduces by 1.
+typedef struct
+{
+    int32_t clockwiseness;
+    int32_t dx_clockwiseness;
+    int32_t dy_clockwiseness;
+    int32_t x, y;
+    uint32_t remaining;
+} LineTraverserCompact;
+
 /// Initializes a LineTraverser for a given line.
 /// @param x1 is the x coordinate of the starting point of the line.
 /// @param y1 is the y coordinate of the starting point of the line.
@@ -33,6 +47,56 @@ typedef struct
 /// that grid square will be traversed.
 LineTraverser LineTraverser_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width);
 
+/// Initializes a LineTraverser for a given line, on a grid where the square width is a power of 2.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_shift is the power of 2 of the width of a square in the grid, so square_width = (1 << square_shift).
+/// @returns a LineTraverser which can be used to traverse all grid points which intersect the line.
+/// @remarks This gives exactly the same LineTraverser as LineTraverser_init() with square_width = (1 << square_shift),
+/// including for negative coordinates, but uses shifts and masks instead of integer division.
+/// LineTraverser_init() and LineTraverser_get_endpoints() already do this when square_width is a power of 2,
+/// so this only saves checking square_width when the shift is known ahead of time.
+LineTraverser LineTraverser_init_shift(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_shift);
+
+/// Initializes a LineTraverser for the part of a line between two parameters, where the line is
+/// (x1, y1) + t * (x2 - x1, y2 - y1) and t = 0 is the start and t = 1 is the end.
+/// @param p_out_traverser is a pointer to write the traverser to.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param t_begin_numerator is the numerator of the parameter where the traversal begins.
+/// @param t_begin_denominator is the positive denominator of the parameter where the traversal begins.
+/// @param t_end_numerator is the numerator of the parameter where the traversal ends.
+/// @param t_end_denominator is the positive denominator of the parameter where the traversal ends.
+/// @returns true if any grid square is traversed between the parameters, false otherwise.
+/// @remarks The traverser starts at the grid square the line is in at t_begin, and ends at the grid square the line
+/// is in just before t_end, so a boundary crossed exactly at t_begin is included and one crossed exactly at t_end
+/// is not. The parameters are clamped to [0, 1]. Every grid square traversed is one that LineTraverser_init()
+/// would traverse, in the same order, since the traverser keeps the exact clockwiseness of the whole line.
+/// This takes constant time, no matter how far along the line t_begin is.
+bool LineTraverser_init_range(LineTraverser *p_out_traverser, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int64_t t_begin_numerator, int64_t t_begin_denominator,
+    int64_t t_end_numerator, int64_t t_end_denominator);
+
+/// Moves the end of a LineTraverser from LineTraverser_init() to the grid square its steps reach at the end of the
+/// line.
+/// @param p_traverser is a pointer to the traverser to update, which must not have been stepped yet.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @remarks LineTraverser_init() finds the grid squares of the endpoints by dividing towards zero, which doesn't always
+/// match the number of boundaries the steps cross when a coordinate is negative, so the steps of such a line can miss
+/// its end grid square and never stop, or pass through it and stop early. Afterwards the traverser stops after the
+/// steps of the whole line. The end of every line without negative coordinates is left the same.
+void LineTraverser_end_where_reached(LineTraverser *p_traverser, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width);
+
 /// Tests if the current grid square in the traverser is the endpoint of the line.
 /// @param p_traverser is a pointer to the traverser to test.
 /// @returns true if this current grid square is the last one. False otherwise.
@@ -52,6 +116,102 @@ void LineTraverser_get_point(const LineTraverser *p_traverser, int32_t *out_x, i
 /// @param p_traverser is a pointer to the traverser to update.
 void LineTraverser_next(LineTraverser *p_traverser);
 
+/// Inline body of LineTraverser_is_end(), which the C++ templates in line_traverser.hpp also use.
+static inline bool line_traverser_is_end_inline(const LineTraverser *p_traverser)
+{
+    return p_traverser->x == p_traverser->end_x &&
+        p_traverser->y == p_traverser->end_y;
+}
+
+/// Inline body of LineTraverser_next(), which the C++ templates in line_traverser.hpp also use.
+static inline void line_traverser_next_inline(LineTraverser *p_traverser)
+{
+    int64_t old_clockwiseness = p_traverser->clockwiseness;
+    if (old_clockwiseness >= 0)
+    {
+        p_traverser->x += p_traverser->dx_x;
+        p_traverser->clockwiseness += p_traverser->dx_clockwiseness;
+    }
+    if (old_clockwiseness <= 0)
+    {
+        p_traverser->y += p_traverser->dy_y;
+        p_traverser->clockwiseness += p_traverser->dy_clockwiseness;
+    }
+}
+
+/// Updates a LineTraverser to the last grid coordinate of the line in its current row.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @remarks This takes constant time. Calling LineTraverser_next() afterwards will move to the next row.
+void LineTraverser_skip_row(LineTraverser *p_traverser);
+
+/// Updates a LineTraverser to the last grid coordinate of the line in its current column.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @remarks This takes constant time. Calling LineTraverser_next() afterwards will move to the next column.
+void LineTraverser_skip_column(LineTraverser *p_traverser);
+
+/// Updates a LineTraverser to the last grid coordinate of its current span.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @remarks A span is a run of grid squares on the line that share the same row (if |dx| >= |dy|)
+/// or the same column (if |dy| > |dx|). The length of the span is calculated directly from the
+/// clockwiseness, so this takes constant time no matter how long the span is.
+/// If the traverser is already on the last grid square of its span, it is not changed.
+/// Calling LineTraverser_next() afterwards will move to the first grid square of the next span.
+void LineTraverser_skip_span(LineTraverser *p_traverser);
+
+/// Updates a LineTraverser by a number of steps at once.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @param steps is the number of times LineTraverser_next() would be called.
+/// @returns true if the traverser was updated, false if steps is negative or goes past the end of the line.
+/// If false is returned, the traverser is not changed.
+/// @remarks The new state is calculated directly, and is identical to the state that calling LineTraverser_next()
+/// steps times would give. This takes O(log(length)^2) time.
+bool LineTraverser_seek(LineTraverser *p_traverser, int64_t steps);
+
+/// Updates a LineTraverser to the first grid square of the line in a column.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @param x is the x grid coordinate of the column.
+/// @returns the number of steps the traverser was moved, or -1 if the line does not reach the column
+/// between the current grid square and the end of the line. If -1 is returned, the traverser is not changed.
+/// @remarks This takes O(log(length)) time. If the traverser is already in the column, it is not changed.
+int64_t LineTraverser_seek_column(LineTraverser *p_traverser, int32_t x);
+
+/// Updates a LineTraverser to the first grid square of the line in a row.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @param y is the y grid coordinate of the row.
+/// @returns the number of steps the traverser was moved, or -1 if the line does not reach the row
+/// between the current grid square and the end of the line. If -1 is returned, the traverser is not changed.
+/// @remarks This takes O(log(length)) time. If the traverser is already in the row, it is not changed.
+int64_t LineTraverser_seek_row(LineTraverser *p_traverser, int32_t y);
+
+/// Clips a LineTraverser to the grid squares of its line that lie inside of a rectangle.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @param rect_min_x is the inclusive minimum x grid coordinate of the rectangle.
+/// @param rect_min_y is the inclusive minimum y grid coordinate of the rectangle.
+/// @param rect_max_x is the inclusive maximum x grid coordinate of the rectangle.
+/// @param rect_max_y is the inclusive maximum y grid coordinate of the rectangle.
+/// @returns true if any grid square between the current one and the end of the line is inside the rectangle.
+/// If false is returned, the traverser is not changed.
+/// @remarks The traverser is moved to the first grid square inside the rectangle, and its end is set to the last one,
+/// so traversing it visits exactly the grid squares of the original traversal that are inside the rectangle.
+/// The clockwiseness is not rounded, so the line keeps its exact slope.
+bool LineTraverser_clip_to_rect(LineTraverser *p_traverser,
+    int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y);
+
+/// Writes the current grid coordinate of a LineTraverser and the ones following it into buffers.
+/// @param p_traverser is a pointer to the traverser to read and update.
+/// @param out_x is a buffer to write up to max_count x coordinates to.
+/// @param out_y is a buffer to write up to max_count y coordinates to.
+/// @param max_count is the number of coordinates which fit in out_x and out_y.
+/// @param out_count is a pointer to write the number of coordinates which were written.
+/// @returns true if the last grid square of the line was written, false otherwise.
+/// @remarks This writes the same grid squares in the same order as calling LineTraverser_get_point() and
+/// LineTraverser_next() in a loop, but fills whole spans at a time (see LineTraverser_skip_span()).
+/// If this returns false, the traverser is updated to the first grid square which was not written yet,
+/// so calling this again continues where the previous call stopped.
+/// If this returns true, the traverser is left on the last grid square of the line and should not be used again.
+bool LineTraverser_next_points(LineTraverser *p_traverser, int32_t *out_x, int32_t *out_y,
+    int32_t max_count, int32_t *out_count);
+
 /// Gets the grid-coordinates of the endpoints of a line.
 /// @param x1 is the x coordinate of the starting point of the line.
 /// @param y1 is the y coordinate of the starting point of the line.
@@ -68,6 +228,97 @@ void LineTraverser_next(LineTraverser *p_traverser);
 void LineTraverser_get_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
     int32_t *out_x1, int32_t *out_y1, int32_t *out_x2, int32_t *out_y2);
 
+/// Counts the grid squares from the current grid square of a LineTraverser to the end of the line.
+/// @param p_traverser is a pointer to the traverser to count the remaining grid squares of.
+/// @returns the number of grid squares that LineTraverser_next() would visit until LineTraverser_is_end()
+/// returns true, including both the current and the last grid square.
+/// @remarks This does not traverse the line. The diagonal steps (where the clockwiseness is exactly 0) are
+/// counted by solving a linear diophantine equation, so this takes O(log(square_width * length)) time.
+int64_t LineTraverser_count_remaining(const LineTraverser *p_traverser);
+
+/// Counts the grid squares that LineTraverser_traverse_include_endpoints() would visit for a line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @returns the number of grid squares which intersect the line, including both endpoints.
+int64_t LineTraverser_count_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width);
+
+/// Counts the grid squares that LineTraverser_traverse_exclude_endpoints() would visit for a line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @returns the number of grid squares which intersect the line, excluding both endpoints.
+int64_t LineTraverser_count_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width);
+
+/// Counts the grid squares that LineTraverser_traverse_include_endpoints() would visit inside of a rectangle.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param rect_min_x is the inclusive minimum x grid coordinate of the rectangle.
+/// @param rect_min_y is the inclusive minimum y grid coordinate of the rectangle.
+/// @param rect_max_x is the inclusive maximum x grid coordinate of the rectangle.
+/// @param rect_max_y is the inclusive maximum y grid coordinate of the rectangle.
+/// @returns the number of grid squares which intersect the line and lie inside the rectangle, including endpoints.
+/// @remarks The rectangle is given in grid coordinates (the same coordinates passed to the traversal callback),
+/// not in the coordinates of the line.
+int64_t LineTraverser_count_inside_rect_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y);
+
+/// Counts the grid squares that LineTraverser_traverse_exclude_endpoints() would visit inside of a rectangle.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param rect_min_x is the inclusive minimum x grid coordinate of the rectangle.
+/// @param rect_min_y is the inclusive minimum y grid coordinate of the rectangle.
+/// @param rect_max_x is the inclusive maximum x grid coordinate of the rectangle.
+/// @param rect_max_y is the inclusive maximum y grid coordinate of the rectangle.
+/// @returns the number of grid squares which intersect the line and lie inside the rectangle, excluding endpoints.
+int64_t LineTraverser_count_inside_rect_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t rect_min_x, int32_t rect_min_y, int32_t rect_max_x, int32_t rect_max_y);
+
+/// Tests if a line can be traversed with a LineTraverserCompact.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @returns true if 2 * (|dx| + |dy|) * square_width is less than 2^31, so the clockwiseness fits in 32 bits.
+/// @remarks square_width must be positive.
+bool LineTraverserCompact_fits(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width);
+
+/// Initializes a LineTraverserCompact for a given line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @returns a LineTraverserCompact which traverses the same grid squares as LineTraverser_init() would.
+/// @remarks LineTraverserCompact_fits() must be true for the line.
+LineTraverserCompact LineTraverserCompact_init(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width);
+
+/// Tests if the current grid square in the traverser is the endpoint of the line.
+/// @param p_traverser is a pointer to the traverser to test.
+/// @returns true if this current grid square is the last one. False otherwise.
+bool LineTraverserCompact_is_end(const LineTraverserCompact *p_traverser);
+
+/// Gets the current grid square coordinate of a LineTraverserCompact.
+/// @param p_traverser is a pointer to the traverser to get the coordinate of.
+/// @param out_x is a pointer to write the x coordinate to.
+/// @param out_y is a pointer to write the y coordinate to.
+void LineTraverserCompact_get_point(const LineTraverserCompact *p_traverser, int32_t *out_x, int32_t *out_y);
+
+/// Updates a LineTraverserCompact to the next grid coordinate.
+/// @param p_traverser is a pointer to the traverser to update.
+void LineTraverserCompact_next(LineTraverserCompact *p_traverser);
+
 /// User defined function which can be called during a line traversal.
 /// @param x is the x coordinate of current grid square that intersects the line.
 /// @param y is the y coordinate of current grid square that intersects the line.
@@ -90,6 +341,7 @@ typedef void (*LineTraverserCallback)(int32_t x, int32_t y, void *user_data);
 /// The meaning of "include_endpoints" is that both starting and ending grid squares will be called during
 /// traversal. The alternative is LineTraverser_traverse_exclude_endpoints() which will exclude exactly one
 /// endpoint on each side of the line.
+/// Lines where LineTraverserCompact_fits() is true are traversed with a LineTraverserCompact.
 void LineTraverser_traverse_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width, 
     LineTraverserCallback callback, void *user_data);
 
@@ -110,7 +362,164 @@ void LineTraverser_traverse_include_endpoints(int32_t x1, int32_t y1, int32_t x2
 /// traversal. They will be excluded, even if the endpoint lies exactly on the edge of a grid square.
 /// The alternative is LineTraverser_traverse_include_endpoints() which will call callback() for every point
 /// that intersects the line. Usually, you probably want to use LineTraverser_traverse_include_endpoints().
+/// Lines where LineTraverserCompact_fits() is true are traversed with a LineTraverserCompact.
 void LineTraverser_traverse_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width, 
     LineTraverserCallback callback, void *user_data);
 
+/// User defined function which can be called for every span during a line traversal.
+/// @param x1 is the x coordinate of the first grid square in the span.
+/// @param y1 is the y coordinate of the first grid square in the span.
+/// @param x2 is the x coordinate of the last grid square in the span.
+/// @param y2 is the y coordinate of the last grid square in the span.
+/// @param user_data is a pointer to user defined data.
+/// @remarks Every span is either horizontal (y1 == y2) or vertical (x1 == x2). The span is given in
+/// traversal order, so x2 may be less than x1, and y2 may be less than y1. Both ends are inclusive.
+typedef void (*LineTraverserSpanCallback)(int32_t x1, int32_t y1, int32_t x2, int32_t y2, void *user_data);
+
+/// Traverses all grid squares that intersect a line, one span at a time.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every span on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks This visits exactly the same grid squares, in the same order, as
+/// LineTraverser_traverse_include_endpoints(). Lines where |dx| >= |dy| are given as horizontal spans, and
+/// lines where |dy| > |dx| are given as vertical spans. See LineTraverser_skip_span().
+void LineTraverser_traverse_spans_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserSpanCallback callback, void *user_data);
+
+/// Traverses all grid squares that intersect a line one span at a time, excluding the starting and ending points.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every span on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks This visits exactly the same grid squares, in the same order, as
+/// LineTraverser_traverse_exclude_endpoints().
+void LineTraverser_traverse_spans_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserSpanCallback callback, void *user_data);
+
+/// User defined function which can be called for every row during a line traversal.
+/// @param y is the y coordinate of the row.
+/// @param x_begin is the inclusive minimum x coordinate of the grid squares of the line in this row.
+/// @param x_end is the inclusive maximum x coordinate of the grid squares of the line in this row.
+/// @param user_data is a pointer to user defined data.
+typedef void (*LineTraverserRowCallback)(int32_t y, int32_t x_begin, int32_t x_end, void *user_data);
+
+/// Traverses all grid squares that intersect a line, one row at a time.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called once for every row the line covers.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks This covers exactly the same grid squares as LineTraverser_traverse_include_endpoints(), with the
+/// same rules for corners and edges. The rows are given in the order of the line, starting at the row of (x1,y1),
+/// so y is increasing if y2 > y1 and decreasing otherwise. Every row is given exactly once.
+void LineTraverser_traverse_rows_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserRowCallback callback, void *user_data);
+
+/// Traverses all grid squares that intersect a line one row at a time, excluding the starting and ending points.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called once for every row the line covers.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks This covers exactly the same grid squares as LineTraverser_traverse_exclude_endpoints().
+/// Rows which only contain an endpoint are not given.
+void LineTraverser_traverse_rows_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserRowCallback callback, void *user_data);
+
+/// User defined function which can be called during a line traversal, and can stop the traversal.
+/// @param x is the x coordinate of current grid square that intersects the line.
+/// @param y is the y coordinate of current grid square that intersects the line.
+/// @param user_data is a pointer to user defined data.
+/// @returns true to continue the traversal, or false to stop at this grid square.
+typedef bool (*LineTraverserVisitor)(int32_t x, int32_t y, void *user_data);
+
+/// Traverses the grid squares that intersect a line until the visitor stops the traversal.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param visitor is a user-defined function which will be called for every point on the line, until it returns false.
+/// @param user_data is a pointer to user data passed to visitor().
+/// @param out_count is a pointer to write the number of grid squares visited, including the one the visitor stopped at.
+/// @param out_x is a pointer to write the x coordinate of the last grid square visited.
+/// @param out_y is a pointer to write the y coordinate of the last grid square visited.
+/// @returns true if the visitor stopped the traversal, false if every grid square was visited.
+/// @remarks This visits the same grid squares, in the same order, as LineTraverser_traverse_include_endpoints().
+/// This is useful for ray casting and line of sight tests, where the visitor returns false once it hits something.
+bool LineTraverser_traverse_until_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserVisitor visitor, void *user_data,
+    int64_t *out_count, int32_t *out_x, int32_t *out_y);
+
+/// Traverses the grid squares that intersect a line excluding the endpoints, until the visitor stops the traversal.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param visitor is a user-defined function which will be called for every point on the line, until it returns false.
+/// @param user_data is a pointer to user data passed to visitor().
+/// @param out_count is a pointer to write the number of grid squares visited, including the one the visitor stopped at.
+/// @param out_x is a pointer to write the x coordinate of the last grid square visited.
+/// @param out_y is a pointer to write the y coordinate of the last grid square visited.
+/// @returns true if the visitor stopped the traversal, false if every grid square was visited.
+/// @remarks This visits the same grid squares, in the same order, as LineTraverser_traverse_exclude_endpoints().
+/// If no grid square is visited, out_count is set to 0 and out_x and out_y are not written.
+bool LineTraverser_traverse_until_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserVisitor visitor, void *user_data,
+    int64_t *out_count, int32_t *out_x, int32_t *out_y);
+
+/// User defined function which can be called during a line traversal, with the part of the line in the grid square.
+/// @param x is the x coordinate of current grid square that intersects the line.
+/// @param y is the y coordinate of current grid square that intersects the line.
+/// @param t_enter is the numerator of the parameter t where the line enters the grid square.
+/// @param t_exit is the numerator of the parameter t where the line exits the grid square.
+/// @param t_denominator is the denominator of t_enter and t_exit. It is the same for every grid square of a line.
+/// @param user_data is a pointer to user defined data.
+/// @remarks The point on the line at parameter t is (x1,y1) + t * (x2-x1, y2-y1), so t goes from 0 at the starting
+/// point to 1 at the ending point. The length of the line inside the grid square is
+/// (t_exit - t_enter) / t_denominator times the length of the line.
+typedef void (*LineTraverserParametricCallback)(int32_t x, int32_t y, int64_t t_enter, int64_t t_exit,
+    int64_t t_denominator, void *user_data);
+
+/// Traverses all grid squares that intersect a line, giving the exact parameter range of the line in each.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every point on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks This visits the same grid squares, in the same order, as LineTraverser_traverse_include_endpoints().
+/// The entry and exit parameters are exact rationals, updated incrementally with integer additions alongside the
+/// clockwiseness. The first grid square is entered at t = 0, the last one is exited at t = 1, and every grid square
+/// is entered where the previous one was exited.
+void LineTraverser_traverse_parametric_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserParametricCallback callback, void *user_data);
+
+/// Traverses all grid squares that intersect a line excluding the endpoints, giving the exact parameter range
+/// of the line in each.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every point on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks This visits the same grid squares, in the same order, as LineTraverser_traverse_exclude_endpoints().
+/// The parameters are still relative to the whole line, see LineTraverser_traverse_parametric_include_endpoints().
+void LineTraverser_traverse_parametric_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserParametricCallback callback, void *user_data);
+
 #endif // LINE_TRAVERSER_H
@@ -0,0 +1,110 @@
+
+/// line_traverser.hpp
+/// Provides header-only C++ templates for traversing a line over a grid, where the starting and ending points
+/// have sub-grid coordinates. The visitor is a template parameter, so it can be inlined into the traversal loop.
+
+#ifndef LINE_TRAVERSER_HPP
+#define LINE_TRAVERSER_HPP
+
+#include <type_traits>
+#include "line_traverser.h"
+
+namespace line_traverser
+{
+
+/// Calls a visitor for a grid square.
+/// @returns false if the visitor returned false to stop the traversal, true otherwise.
+/// @remarks Visitors may return void (never stop) or anything convertible to bool.
+template <typename Visitor>
+inline bool visit(Visitor &visitor, int32_t x, int32_t y)
+{
+    if constexpr (std::is_void<decltype(visitor(x, y))>::value)
+    {
+        visitor(x, y);
+        return true;
+    }
+    else
+    {
+        return static_cast<bool>(visitor(x, y));
+    }
+}
+
+/// Updates a LineTraverser to the next grid coordinate. Same as LineTraverser_next(), but can be inlined.
+/// @param traverser is the traverser to update.
+inline void next(LineTraverser &traverser)
+{
+    line_traverser_next_inline(&traverser);
+}
+
+/// Tests if a LineTraverser is on the last grid square. Same as LineTraverser_is_end(), but can be inlined.
+/// @param traverser is the traverser to test.
+inline bool is_end(const LineTraverser &traverser)
+{
+    return line_traverser_is_end_inline(&traverser);
+}
+
+/// Visits the grid squares of a LineTraverser, from the current grid square to the end of the line.
+/// @param traverser is the traverser to update.
+/// @param visitor is a function or lambda called as visitor(x, y) for every grid square.
+/// @returns true if every grid square was visited, false if the visitor returned false to stop early.
+/// @remarks When stopped early, the traverser is left on the grid square which the visitor stopped at.
+/// Otherwise it is left on the last grid square of the line.
+template <typename Visitor>
+inline bool traverse(LineTraverser &traverser, Visitor &&visitor)
+{
+    while (true)
+    {
+        if (!visit(visitor, traverser.x, traverser.y))
+            return false;
+        if (is_end(traverser))
+            return true;
+        next(traverser);
+    }
+}
+
+/// Visits all grid squares that intersect a line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param visitor is a function or lambda called as visitor(x, y) for every grid square.
+/// @returns true if every grid square was visited, false if the visitor returned false to stop early.
+/// @remarks Visits the same grid squares as LineTraverser_traverse_include_endpoints().
+template <typename Visitor>
+inline bool traverse_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+    Visitor &&visitor)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    return traverse(traverser, visitor);
+}
+
+/// Visits all grid squares that intersect a line, excluding the starting and ending points.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param visitor is a function or lambda called as visitor(x, y) for every grid square.
+/// @returns true if every grid square was visited, false if the visitor returned false to stop early.
+/// @remarks Visits the same grid squares as LineTraverser_traverse_exclude_endpoints().
+template <typename Visitor>
+inline bool traverse_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+    Visitor &&visitor)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    if (is_end(traverser))
+        return true;
+    while (true)
+    {
+        next(traverser);
+        if (is_end(traverser))
+            return true;
+        if (!visit(visitor, traverser.x, traverser.y))
+            return false;
+    }
+}
+
+} // namespace line_traverser
+
+#endif // LINE_TRAVERSER_HPP
@@ -0,0 +1,196 @@
+/// line_traverser64.c
+/// Provides functions for traversing a line over a grid with 64 bit coordinates, where the starting and ending points
+/// have sub-grid coordinates.
+
+#include "line_traverser64.h"
+#include "line_traverser.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+static inline int64_t line_traverser64_abs(int64_t value)
+{
+    return (value < 0) ? -value : value;
+}
+
+LineTraverser64 LineTraverser64_init(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width)
+{
+    LineTraverser64 traverser;
+    int64_t dx = x2 - x1;
+    int64_t dy = y2 - y1;
+    traverser.dx_x = (dx >= 0) ? 1 : -1;
+    traverser.dy_y = (dy >= 0) ? 1 : -1;
+    int64_t local_x = x1 % square_width;
+    int64_t local_y = y1 % square_width;
+    int64_t x_dist = (dx >= 0) ? (square_width - local_x) : (local_x);
+    int64_t y_dist = (dy >= 0) ? (square_width - local_y) : (local_y);
+    traverser.clockwiseness = (LineTraverserInt128)line_traverser64_abs(dx) * line_traverser64_abs(y_dist) -
+        (LineTraverserInt128)line_traverser64_abs(dy) * line_traverser64_abs(x_dist);
+    traverser.dx_clockwiseness = -(LineTraverserInt128)line_traverser64_abs(dy) * square_width;
+    traverser.dy_clockwiseness = (LineTraverserInt128)line_traverser64_abs(dx) * square_width;
+
+    traverser.x = x1 / square_width;
+    traverser.y = y1 / square_width;
+    traverser.end_x = x2 / square_width;
+    traverser.end_y = y2 / square_width;
+    if (dy < 0)
+    {
+        if (local_y == 0)
+        {
+            traverser.y--;
+            traverser.clockwiseness += traverser.dy_clockwiseness;
+        }
+    }
+    else if (dy > 0)
+    {
+        if ((y2 % square_width) == 0)
+            traverser.end_y--;
+    }
+
+    if (dx < 0)
+    {
+        if (local_x == 0)
+        {
+            traverser.x--;
+            traverser.clockwiseness += traverser.dx_clockwiseness;
+        }
+    }
+    else if (dx > 0)
+    {
+        if ((x2 % square_width) == 0)
+            traverser.end_x--;
+    }
+    return traverser;
+}
+
+bool LineTraverser64_is_end(const LineTraverser64 *p_traverser)
+{
+    return p_traverser->x == p_traverser->end_x && p_traverser->y == p_traverser->end_y;
+}
+
+void LineTraverser64_get_point(const LineTraverser64 *p_traverser, int64_t *out_x, int64_t *out_y)
+{
+    *out_x = p_traverser->x;
+    *out_y = p_traverser->y;
+}
+
+void LineTraverser64_next(LineTraverser64 *p_traverser)
+{
+    LineTraverserInt128 old_clockwiseness = p_traverser->clockwiseness;
+    if (old_clockwiseness >= 0)
+    {
+        p_traverser->x += p_traverser->dx_x;
+        p_traverser->clockwiseness += p_traverser->dx_clockwiseness;
+    }
+    if (old_clockwiseness <= 0)
+    {
+        p_traverser->y += p_traverser->dy_y;
+        p_traverser->clockwiseness += p_traverser->dy_clockwiseness;
+    }
+}
+
+void LineTraverser64_get_endpoints(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width,
+    int64_t *out_x1, int64_t *out_y1, int64_t *out_x2, int64_t *out_y2)
+{
+    int64_t dx = x2 - x1;
+    int64_t dy = y2 - y1;
+    *out_x1 = x1 / square_width;
+    *out_y1 = y1 / square_width;
+    *out_x2 = x2 / square_width;
+    *out_y2 = y2 / square_width;
+    if (dy < 0)
+    {
+        if ((y1 % square_width) == 0)
+            (*out_y1)--;
+    }
+    else if (dy > 0)
+    {
+        if ((y2 % square_width) == 0)
+            (*out_y2)--;
+    }
+
+    if (dx < 0)
+    {
+        if ((x1 % square_width) == 0)
+            (*out_x1)--;
+    }
+    else if (dx > 0)
+    {
+        if ((x2 % square_width) == 0)
+            (*out_x2)--;
+    }
+}
+
+/// Tests if a line can be traversed by the 32 bit LineTraverser.
+/// LineTraverser_init() subtracts the coordinates in 32 bits, so the differences must fit as well.
+bool line_traverser64_fits32(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width)
+{
+    if (min(min(x1, x2), min(y1, y2)) < INT32_MIN || max(max(x1, x2), max(y1, y2)) > INT32_MAX)
+        return false;
+    if (square_width > INT32_MAX)
+        return false;
+    return line_traverser64_abs(x2 - x1) <= INT32_MAX && line_traverser64_abs(y2 - y1) <= INT32_MAX;
+}
+
+/// Passes the callback of a 64 bit traversal through a 32 bit traversal.
+typedef struct
+{
+    LineTraverser64Callback callback;
+    void *user_data;
+} LineTraverser64Forward;
+
+void line_traverser64_forward_callback(int32_t x, int32_t y, void *user_data)
+{
+    LineTraverser64Forward *p_forward = (LineTraverser64Forward*)user_data;
+    p_forward->callback(x, y, p_forward->user_data);
+}
+
+void LineTraverser64_traverse_include_endpoints(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width,
+    LineTraverser64Callback callback, void *user_data)
+{
+    if (line_traverser64_fits32(x1, y1, x2, y2, square_width))
+    {
+        LineTraverser64Forward forward = { callback, user_data };
+        LineTraverser_traverse_include_endpoints((int32_t)x1, (int32_t)y1, (int32_t)x2, (int32_t)y2,
+            (int32_t)square_width, line_traverser64_forward_callback, &forward);
+        return;
+    }
+    LineTraverser64 traverser = LineTraverser64_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int64_t x, y;
+        LineTraverser64_get_point(&traverser, &x, &y);
+        callback(x, y, user_data);
+        if (LineTraverser64_is_end(&traverser))
+            break;
+        LineTraverser64_next(&traverser);
+    }
+}
+
+void LineTraverser64_traverse_exclude_endpoints(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width,
+    LineTraverser64Callback callback, void *user_data)
+{
+    if (line_traverser64_fits32(x1, y1, x2, y2, square_width))
+    {
+        LineTraverser64Forward forward = { callback, user_data };
+        LineTraverser_traverse_exclude_endpoints((int32_t)x1, (int32_t)y1, (int32_t)x2, (int32_t)y2,
+            (int32_t)square_width, line_traverser64_forward_callback, &forward);
+        return;
+    }
+    LineTraverser64 traverser = LineTraverser64_init(x1, y1, x2, y2, square_width);
+    if (LineTraverser64_is_end(&traverser))
+        return;
+    while (true)
+    {
+        LineTraverser64_next(&traverser);
+        if (LineTraverser64_is_end(&traverser))
+            break;
+        int64_t x, y;
+        LineTraverser64_get_point(&traverser, &x, &y);
+        callback(x, y, user_data);
+    }
+}
@@ -0,0 +1,95 @@
+/// line_traverser64.h
+/// Provides functions for traversing a line over a grid with 64 bit coordinates, where the starting and ending points
+/// have sub-grid coordinates.
+
+#ifndef LINE_TRAVERSER64_H
+#define LINE_TRAVERSER64_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+__extension__ typedef __int128 LineTraverserInt128;
+
+/// 64 bit coordinate version of LineTraverser. The clockwiseness is the product of a coordinate difference
+/// and a distance inside a grid square, so it needs 128 bits.
+typedef struct
+{
+    LineTraverserInt128 clockwiseness;
+    LineTraverserInt128 dx_clockwiseness;
+    LineTraverserInt128 dy_clockwiseness;
+    int64_t x, y;
+    int64_t dx_x, dy_y;
+    int64_t end_x, end_y;
+} LineTraverser64;
+
+/// Initializes a LineTraverser64 for a given line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @returns a LineTraverser64 which can be used to traverse all grid points which intersect the line.
+/// @remarks This traverses exactly the same grid squares as LineTraverser_init() would, if the coordinates fit in it.
+/// x2 - x1 and y2 - y1 must fit in an int64_t.
+LineTraverser64 LineTraverser64_init(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width);
+
+/// Tests if the current grid square in the traverser is the endpoint of the line.
+/// @param p_traverser is a pointer to the traverser to test.
+/// @returns true if this current grid square is the last one. False otherwise.
+/// @remarks See LineTraverser_is_end().
+bool LineTraverser64_is_end(const LineTraverser64 *p_traverser);
+
+/// Gets the current grid square coordinate of a LineTraverser64.
+/// @param p_traverser is a pointer to the traverser to get the coordinate of.
+/// @param out_x is a pointer to write the x coordinate to.
+/// @param out_y is a pointer to write the y coordinate to.
+void LineTraverser64_get_point(const LineTraverser64 *p_traverser, int64_t *out_x, int64_t *out_y);
+
+/// Updates a LineTraverser64 to the next grid coordinate.
+/// @param p_traverser is a pointer to the traverser to update.
+void LineTraverser64_next(LineTraverser64 *p_traverser);
+
+/// Gets the grid coordinates of the endpoints of a line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param out_x1 is a pointer to write the x coordinate which corresponds to x1 in grid coordinates.
+/// @param out_y1 is a pointer to write the y coordinate which corresponds to y1 in grid coordinates.
+/// @param out_x2 is a pointer to write the x coordinate which corresponds to x2 in grid coordinates.
+/// @param out_y2 is a pointer to write the y coordinate which corresponds to y2 in grid coordinates.
+void LineTraverser64_get_endpoints(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width,
+    int64_t *out_x1, int64_t *out_y1, int64_t *out_x2, int64_t *out_y2);
+
+/// User defined function which can be called during a line traversal.
+/// @param x is the x coordinate of current grid square that intersects the line.
+/// @param y is the y coordinate of current grid square that intersects the line.
+/// @param user_data is a pointer to user defined data.
+typedef void (*LineTraverser64Callback)(int64_t x, int64_t y, void *user_data);
+
+/// Traverses all grid squares that intersect a line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every grid square on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks Lines that fit in 32 bit coordinates are traversed with LineTraverser instead.
+void LineTraverser64_traverse_include_endpoints(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width,
+    LineTraverser64Callback callback, void *user_data);
+
+/// Traverses all grid squares that intersect a line, excluding the starting and ending squares.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every grid square on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks Lines that fit in 32 bit coordinates are traversed with LineTraverser instead.
+void LineTraverser64_traverse_exclude_endpoints(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width,
+    LineTraverser64Callback callback, void *user_data);
+
+#endif // LINE_TRAVERSER64_H
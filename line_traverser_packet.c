@@ -0,0 +1,158 @@
+
+/// line_traverser_packet.c
+/// Provides functions for traversing several lines over a grid at once, using SIMD instructions when available.
+
+#include "line_traverser_packet.h"
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+uint32_t LineTraverserPacket_init(LineTraverserPacket *p_packet, const int32_t *x1, const int32_t *y1,
+    const int32_t *x2, const int32_t *y2, int32_t square_width, int32_t count)
+{
+    for (int32_t i = 0; i < LINE_TRAVERSER_PACKET_WIDTH; i++)
+    {
+        LineTraverser traverser;
+        if (i < count)
+            traverser = LineTraverser_init(x1[i], y1[i], x2[i], y2[i], square_width);
+        else
+            traverser = LineTraverser_init(0, 0, 0, 0, square_width);
+        p_packet->clockwiseness[i] = traverser.clockwiseness;
+        p_packet->dx_clockwiseness[i] = traverser.dx_clockwiseness;
+        p_packet->dy_clockwiseness[i] = traverser.dy_clockwiseness;
+        p_packet->x[i] = traverser.x;
+        p_packet->y[i] = traverser.y;
+        p_packet->dx_x[i] = traverser.dx_x;
+        p_packet->dy_y[i] = traverser.dy_y;
+        p_packet->end_x[i] = traverser.end_x;
+        p_packet->end_y[i] = traverser.end_y;
+    }
+    if (count >= LINE_TRAVERSER_PACKET_WIDTH)
+        p_packet->active_mask = (uint32_t)(((uint64_t)1 << LINE_TRAVERSER_PACKET_WIDTH) - 1);
+    else
+        p_packet->active_mask = (count > 0) ? (((uint32_t)1 << count) - 1) : 0;
+    return p_packet->active_mask;
+}
+
+void LineTraverserPacket_get_points(const LineTraverserPacket *p_packet, int32_t *out_x, int32_t *out_y)
+{
+    for (int32_t i = 0; i < LINE_TRAVERSER_PACKET_WIDTH; i++)
+    {
+        out_x[i] = p_packet->x[i];
+        out_y[i] = p_packet->y[i];
+    }
+}
+
+#if defined(__AVX512F__)
+
+uint32_t LineTraverserPacket_next(LineTraverserPacket *p_packet)
+{
+    __m512i x = _mm512_loadu_si512(p_packet->x);
+    __m512i y = _mm512_loadu_si512(p_packet->y);
+    __mmask16 at_end = _mm512_cmpeq_epi32_mask(x, _mm512_loadu_si512(p_packet->end_x)) &
+        _mm512_cmpeq_epi32_mask(y, _mm512_loadu_si512(p_packet->end_y));
+    __mmask16 step = (__mmask16)p_packet->active_mask & ~at_end;
+
+    __m512i zero = _mm512_setzero_si512();
+    __m512i c_lo = _mm512_loadu_si512(p_packet->clockwiseness);
+    __m512i c_hi = _mm512_loadu_si512(p_packet->clockwiseness + 8);
+    __mmask8 x_step_lo = _mm512_mask_cmpge_epi64_mask((__mmask8)step, c_lo, zero);
+    __mmask8 x_step_hi = _mm512_mask_cmpge_epi64_mask((__mmask8)(step >> 8), c_hi, zero);
+    __mmask8 y_step_lo = _mm512_mask_cmple_epi64_mask((__mmask8)step, c_lo, zero);
+    __mmask8 y_step_hi = _mm512_mask_cmple_epi64_mask((__mmask8)(step >> 8), c_hi, zero);
+
+    c_lo = _mm512_mask_add_epi64(c_lo, x_step_lo, c_lo, _mm512_loadu_si512(p_packet->dx_clockwiseness));
+    c_hi = _mm512_mask_add_epi64(c_hi, x_step_hi, c_hi, _mm512_loadu_si512(p_packet->dx_clockwiseness + 8));
+    c_lo = _mm512_mask_add_epi64(c_lo, y_step_lo, c_lo, _mm512_loadu_si512(p_packet->dy_clockwiseness));
+    c_hi = _mm512_mask_add_epi64(c_hi, y_step_hi, c_hi, _mm512_loadu_si512(p_packet->dy_clockwiseness + 8));
+    _mm512_storeu_si512(p_packet->clockwiseness, c_lo);
+    _mm512_storeu_si512(p_packet->clockwiseness + 8, c_hi);
+
+    __mmask16 x_step = (__mmask16)(x_step_lo | ((uint32_t)x_step_hi << 8));
+    __mmask16 y_step = (__mmask16)(y_step_lo | ((uint32_t)y_step_hi << 8));
+    x = _mm512_mask_add_epi32(x, x_step, x, _mm512_loadu_si512(p_packet->dx_x));
+    y = _mm512_mask_add_epi32(y, y_step, y, _mm512_loadu_si512(p_packet->dy_y));
+    _mm512_storeu_si512(p_packet->x, x);
+    _mm512_storeu_si512(p_packet->y, y);
+
+    p_packet->active_mask = step;
+    return p_packet->active_mask;
+}
+
+#elif defined(__AVX2__)
+
+/// Packs two vectors of 4 64-bit masks into one vector of 8 32-bit masks, keeping the lane order.
+static inline __m256i line_traverser_packet_pack_mask(__m256i lo, __m256i hi)
+{
+    __m256i packed = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi),
+        _MM_SHUFFLE(2, 0, 2, 0)));
+    return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+uint32_t LineTraverserPacket_next(LineTraverserPacket *p_packet)
+{
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i active = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int32_t)p_packet->active_mask),
+        lane_bits), lane_bits);
+    __m256i x = _mm256_loadu_si256((const __m256i*)p_packet->x);
+    __m256i y = _mm256_loadu_si256((const __m256i*)p_packet->y);
+    __m256i at_end = _mm256_and_si256(
+        _mm256_cmpeq_epi32(x, _mm256_loadu_si256((const __m256i*)p_packet->end_x)),
+        _mm256_cmpeq_epi32(y, _mm256_loadu_si256((const __m256i*)p_packet->end_y)));
+    __m256i step = _mm256_andnot_si256(at_end, active);
+    __m256i step_lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(step));
+    __m256i step_hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(step, 1));
+
+    __m256i zero = _mm256_setzero_si256();
+    __m256i c_lo = _mm256_loadu_si256((const __m256i*)p_packet->clockwiseness);
+    __m256i c_hi = _mm256_loadu_si256((const __m256i*)(p_packet->clockwiseness + 4));
+    __m256i x_step_lo = _mm256_andnot_si256(_mm256_cmpgt_epi64(zero, c_lo), step_lo);
+    __m256i x_step_hi = _mm256_andnot_si256(_mm256_cmpgt_epi64(zero, c_hi), step_hi);
+    __m256i y_step_lo = _mm256_andnot_si256(_mm256_cmpgt_epi64(c_lo, zero), step_lo);
+    __m256i y_step_hi = _mm256_andnot_si256(_mm256_cmpgt_epi64(c_hi, zero), step_hi);
+
+    c_lo = _mm256_add_epi64(c_lo, _mm256_and_si256(x_step_lo,
+        _mm256_loadu_si256((const __m256i*)p_packet->dx_clockwiseness)));
+    c_hi = _mm256_add_epi64(c_hi, _mm256_and_si256(x_step_hi,
+        _mm256_loadu_si256((const __m256i*)(p_packet->dx_clockwiseness + 4))));
+    c_lo = _mm256_add_epi64(c_lo, _mm256_and_si256(y_step_lo,
+        _mm256_loadu_si256((const __m256i*)p_packet->dy_clockwiseness)));
+    c_hi = _mm256_add_epi64(c_hi, _mm256_and_si256(y_step_hi,
+        _mm256_loadu_si256((const __m256i*)(p_packet->dy_clockwiseness + 4))));
+    _mm256_storeu_si256((__m256i*)p_packet->clockwiseness, c_lo);
+    _mm256_storeu_si256((__m256i*)(p_packet->clockwiseness + 4), c_hi);
+
+    __m256i x_step = line_traverser_packet_pack_mask(x_step_lo, x_step_hi);
+    __m256i y_step = line_traverser_packet_pack_mask(y_step_lo, y_step_hi);
+    x = _mm256_add_epi32(x, _mm256_and_si256(x_step, _mm256_loadu_si256((const __m256i*)p_packet->dx_x)));
+    y = _mm256_add_epi32(y, _mm256_and_si256(y_step, _mm256_loadu_si256((const __m256i*)p_packet->dy_y)));
+    _mm256_storeu_si256((__m256i*)p_packet->x, x);
+    _mm256_storeu_si256((__m256i*)p_packet->y, y);
+
+    p_packet->active_mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(step));
+    return p_packet->active_mask;
+}
+
+#else
+
+uint32_t LineTraverserPacket_next(LineTraverserPacket *p_packet)
+{
+    uint32_t step_mask = 0;
+    for (int32_t i = 0; i < LINE_TRAVERSER_PACKET_WIDTH; i++)
+    {
+        bool at_end = p_packet->x[i] == p_packet->end_x[i] && p_packet->y[i] == p_packet->end_y[i];
+        bool step = ((p_packet->active_mask >> i) & 1) && !at_end;
+        int64_t old_clockwiseness = p_packet->clockwiseness[i];
+        bool x_step = step && old_clockwiseness >= 0;
+        bool y_step = step && old_clockwiseness <= 0;
+        p_packet->x[i] += x_step ? p_packet->dx_x[i] : 0;
+        p_packet->y[i] += y_step ? p_packet->dy_y[i] : 0;
+        p_packet->clockwiseness[i] += (x_step ? p_packet->dx_clockwiseness[i] : 0) +
+            (y_step ? p_packet->dy_clockwiseness[i] : 0);
+        step_mask |= (uint32_t)step << i;
+    }
+    p_packet->active_mask = step_mask;
+    return p_packet->active_mask;
+}
+
+#endif
@@ -0,0 +1,68 @@
+
+/// line_traverser_packet.h
+/// Provides functions for traversing several lines over a grid at once, using SIMD instructions when available.
+
+#ifndef LINE_TRAVERSER_PACKET_H
+#define LINE_TRAVERSER_PACKET_H
+
+#include "line_traverser.h"
+
+/// The number of lines in a LineTraverserPacket.
+/// This is 16 when compiled with AVX-512 (-mavx512f), and 8 otherwise (AVX2 is used when compiled with -mavx2).
+#if defined(__AVX512F__)
+#define LINE_TRAVERSER_PACKET_WIDTH 16
+#else
+#define LINE_TRAVERSER_PACKET_WIDTH 8
+#endif
+
+/// Structure of arrays version of LineTraverser. Every lane holds the state of one line.
+typedef struct
+{
+    int64_t clockwiseness[LINE_TRAVERSER_PACKET_WIDTH];
+    int64_t dx_clockwiseness[LINE_TRAVERSER_PACKET_WIDTH];
+    int64_t dy_clockwiseness[LINE_TRAVERSER_PACKET_WIDTH];
+    int32_t x[LINE_TRAVERSER_PACKET_WIDTH];
+    int32_t y[LINE_TRAVERSER_PACKET_WIDTH];
+    int32_t dx_x[LINE_TRAVERSER_PACKET_WIDTH];
+    int32_t dy_y[LINE_TRAVERSER_PACKET_WIDTH];
+    int32_t end_x[LINE_TRAVERSER_PACKET_WIDTH];
+    int32_t end_y[LINE_TRAVERSER_PACKET_WIDTH];
+    uint32_t active_mask;
+} LineTraverserPacket;
+
+/// Initializes a LineTraverserPacket for up to LINE_TRAVERSER_PACKET_WIDTH lines.
+/// @param p_packet is a pointer to the packet to initialize.
+/// @param x1 is an array of the x coordinates of the starting points of the lines.
+/// @param y1 is an array of the y coordinates of the starting points of the lines.
+/// @param x2 is an array of the x coordinates of the ending points of the lines.
+/// @param y2 is an array of the y coordinates of the ending points of the lines.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param count is the number of lines, at most LINE_TRAVERSER_PACKET_WIDTH.
+/// @returns a mask of the active lanes, where bit i is set if lane i holds a line.
+/// @remarks Lane i is initialized the same way as LineTraverser_init() for line i.
+uint32_t LineTraverserPacket_init(LineTraverserPacket *p_packet, const int32_t *x1, const int32_t *y1,
+    const int32_t *x2, const int32_t *y2, int32_t square_width, int32_t count);
+
+/// Gets the current grid square coordinate of every lane in a LineTraverserPacket.
+/// @param p_packet is a pointer to the packet to get the coordinates of.
+/// @param out_x is an array of LINE_TRAVERSER_PACKET_WIDTH to write the x coordinates to.
+/// @param out_y is an array of LINE_TRAVERSER_PACKET_WIDTH to write the y coordinates to.
+/// @remarks The coordinates of inactive lanes are written too, but have no meaning.
+void LineTraverserPacket_get_points(const LineTraverserPacket *p_packet, int32_t *out_x, int32_t *out_y);
+
+/// Updates every active lane of a LineTraverserPacket to its next grid square.
+/// @param p_packet is a pointer to the packet to update.
+/// @returns a mask of the lanes which are still active, where bit i is set if lane i moved to a new grid square.
+/// @remarks Lanes which were on the last grid square of their line are not moved, and become inactive.
+/// Every lane goes through exactly the same states as a LineTraverser of the same line would with
+/// LineTraverser_next(). A full traversal of a packet looks like:
+///
+///     uint32_t mask = LineTraverserPacket_init(&packet, x1, y1, x2, y2, square_width, count);
+///     while (mask != 0)
+///     {
+///         // Use packet.x[i] and packet.y[i] for every bit i set in mask.
+///         mask = LineTraverserPacket_next(&packet);
+///     }
+uint32_t LineTraverserPacket_next(LineTraverserPacket *p_packet);
+
+#endif // LINE_TRAVERSER_PACKET_H
@@ -0,0 +1,144 @@
+
+/// line_traverser_parallel.c
+/// Provides functions for traversing a single long line over a grid using multiple threads.
+
+#include "line_traverser_parallel.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+typedef struct
+{
+    LineTraverser start;
+    int64_t first_step;
+    int64_t step_count;
+    int64_t chunk_count;
+    LineTraverserCallback callback;
+    void *user_data;
+    bool ordered;
+    int32_t *xs;
+    int32_t *ys;
+    pthread_mutex_t mutex;
+    pthread_cond_t chunk_emitted;
+    int64_t next_chunk;
+    int64_t next_chunk_to_emit;
+    int32_t next_worker;
+} LineTraverserParallelJob;
+
+void *line_traverser_parallel_worker(void *p_data)
+{
+    LineTraverserParallelJob *p_job = (LineTraverserParallelJob*)p_data;
+    pthread_mutex_lock(&p_job->mutex);
+    int32_t worker = p_job->next_worker++;
+    pthread_mutex_unlock(&p_job->mutex);
+    int32_t *xs = p_job->xs + (int64_t)worker * LINE_TRAVERSER_PARALLEL_CHUNK_SIZE;
+    int32_t *ys = p_job->ys + (int64_t)worker * LINE_TRAVERSER_PARALLEL_CHUNK_SIZE;
+    while (true)
+    {
+        pthread_mutex_lock(&p_job->mutex);
+        int64_t chunk = p_job->next_chunk++;
+        pthread_mutex_unlock(&p_job->mutex);
+        if (chunk >= p_job->chunk_count)
+            break;
+
+        int64_t chunk_first = p_job->first_step + chunk * LINE_TRAVERSER_PARALLEL_CHUNK_SIZE;
+        int32_t chunk_length = (int32_t)min((int64_t)LINE_TRAVERSER_PARALLEL_CHUNK_SIZE,
+            p_job->first_step + p_job->step_count - chunk_first);
+        LineTraverser traverser = p_job->start;
+        LineTraverser_seek(&traverser, chunk_first);
+        int32_t count;
+        LineTraverser_next_points(&traverser, xs, ys, chunk_length, &count);
+
+        if (p_job->ordered)
+        {
+            pthread_mutex_lock(&p_job->mutex);
+            while (p_job->next_chunk_to_emit != chunk)
+                pthread_cond_wait(&p_job->chunk_emitted, &p_job->mutex);
+            pthread_mutex_unlock(&p_job->mutex);
+        }
+        for (int32_t i = 0; i < count; i++)
+            p_job->callback(xs[i], ys[i], p_job->user_data);
+        if (p_job->ordered)
+        {
+            pthread_mutex_lock(&p_job->mutex);
+            p_job->next_chunk_to_emit++;
+            pthread_cond_broadcast(&p_job->chunk_emitted);
+            pthread_mutex_unlock(&p_job->mutex);
+        }
+    }
+    return NULL;
+}
+
+bool line_traverser_parallel_run(const LineTraverser *p_start, int64_t first_step, int64_t step_count,
+    LineTraverserCallback callback, void *user_data, int32_t thread_count, bool ordered)
+{
+    if (step_count <= 0)
+        return true;
+    LineTraverserParallelJob job;
+    job.start = *p_start;
+    job.first_step = first_step;
+    job.step_count = step_count;
+    job.chunk_count = (step_count + LINE_TRAVERSER_PARALLEL_CHUNK_SIZE - 1) / LINE_TRAVERSER_PARALLEL_CHUNK_SIZE;
+    job.callback = callback;
+    job.user_data = user_data;
+    job.ordered = ordered;
+    job.next_chunk = 0;
+    job.next_chunk_to_emit = 0;
+    job.next_worker = 0;
+
+    // The calling thread is also a worker, so one less thread is started. Every worker has its own chunk of points,
+    // which are all allocated before any grid square is passed to callback().
+    int32_t extra_thread_count = (int32_t)min((int64_t)max(thread_count, 1), job.chunk_count) - 1;
+    size_t buffer_size = sizeof(int32_t) * LINE_TRAVERSER_PARALLEL_CHUNK_SIZE * (extra_thread_count + 1);
+    job.xs = (int32_t*)malloc(buffer_size);
+    job.ys = (int32_t*)malloc(buffer_size);
+    if (!job.xs || !job.ys)
+    {
+        free(job.xs);
+        free(job.ys);
+        return false;
+    }
+    pthread_mutex_init(&job.mutex, NULL);
+    pthread_cond_init(&job.chunk_emitted, NULL);
+
+    // If the threads can't be allocated, the calling thread traverses every chunk.
+    pthread_t *threads = (pthread_t*)malloc(sizeof(pthread_t) * max(extra_thread_count, 1));
+    int32_t started_count = 0;
+    for (int32_t i = 0; threads && i < extra_thread_count; i++)
+    {
+        if (pthread_create(&threads[started_count], NULL, line_traverser_parallel_worker, &job) == 0)
+            started_count++;
+    }
+    line_traverser_parallel_worker(&job);
+    for (int32_t i = 0; i < started_count; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+
+    pthread_cond_destroy(&job.chunk_emitted);
+    pthread_mutex_destroy(&job.mutex);
+    free(job.xs);
+    free(job.ys);
+    return true;
+}
+
+bool LineTraverser_traverse_parallel_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserCallback callback, void *user_data, int32_t thread_count, bool ordered)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t count = LineTraverser_count_remaining(&traverser);
+    return line_traverser_parallel_run(&traverser, 0, count, callback, user_data, thread_count, ordered);
+}
+
+bool LineTraverser_traverse_parallel_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserCallback callback, void *user_data, int32_t thread_count, bool ordered)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    int64_t count = LineTraverser_count_remaining(&traverser);
+    return line_traverser_parallel_run(&traverser, 1, count - 2, callback, user_data, thread_count, ordered);
+}
@@ -0,0 +1,51 @@
+
+/// line_traverser_parallel.h
+/// Provides functions for traversing a single long line over a grid using multiple threads.
+
+#ifndef LINE_TRAVERSER_PARALLEL_H
+#define LINE_TRAVERSER_PARALLEL_H
+
+#include "line_traverser.h"
+
+/// The number of grid squares given to a thread at a time.
+#define LINE_TRAVERSER_PARALLEL_CHUNK_SIZE 4096
+
+/// Traverses all grid squares that intersect a line, splitting the line between multiple threads.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every point on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @param thread_count is the number of threads to use, including the calling thread.
+/// @param ordered is true if callback() must be called in the same order as LineTraverser_traverse_include_endpoints().
+/// @returns true if the line was traversed, false if memory could not be allocated, in which case callback() is
+/// never called.
+/// @remarks The line is split into contiguous chunks of LINE_TRAVERSER_PARALLEL_CHUNK_SIZE grid squares, and every
+/// thread starts its chunk with LineTraverser_seek(), so the chunks together are exactly the grid squares of
+/// LineTraverser_traverse_include_endpoints(), with no grid square missing or repeated at the chunk boundaries.
+/// If ordered is false, callback() is called from multiple threads at the same time, in no particular order,
+/// so it must be thread safe. If ordered is true, the chunks are still traversed in parallel, but callback() is
+/// called by one thread at a time, in the order of the line.
+/// This function returns once every grid square has been passed to callback().
+bool LineTraverser_traverse_parallel_include_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserCallback callback, void *user_data, int32_t thread_count, bool ordered);
+
+/// Traverses all grid squares that intersect a line excluding the endpoints, splitting the line between multiple threads.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a square in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every point on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @param thread_count is the number of threads to use, including the calling thread.
+/// @param ordered is true if callback() must be called in the same order as LineTraverser_traverse_exclude_endpoints().
+/// @returns true if the line was traversed, false if memory could not be allocated, in which case callback() is
+/// never called.
+/// @remarks See LineTraverser_traverse_parallel_include_endpoints().
+bool LineTraverser_traverse_parallel_exclude_endpoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, LineTraverserCallback callback, void *user_data, int32_t thread_count, bool ordered);
+
+#endif // LINE_TRAVERSER_PARALLEL_H
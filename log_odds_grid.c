@@ -0,0 +1,240 @@
+/// log_odds_grid.c
+/// Provides a log-odds occupancy grid which integrates 2D range scans using multiple threads.
+
+#include "log_odds_grid.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/// A cell was traversed by a beam during the current scan.
+#define LOG_ODDS_GRID_FLAG_FREE 1
+/// A beam ended in the cell during the current scan.
+#define LOG_ODDS_GRID_FLAG_OCCUPIED 2
+
+/// The cells that one thread flagged first during a scan. Only that thread updates them.
+typedef struct
+{
+    LogOddsGrid *p_grid;
+    int32_t *cells;
+    int32_t cell_count;
+    int32_t cell_capacity;
+    bool failed;
+} LogOddsGridWorker;
+
+typedef struct
+{
+    LogOddsGrid *p_grid;
+    int32_t origin_x, origin_y;
+    const int32_t *hit_x;
+    const int32_t *hit_y;
+    int32_t beam_count;
+    int32_t square_width;
+    LogOddsGridWorker *workers;
+    int32_t worker_count;
+    pthread_mutex_t mutex;
+    int32_t next_worker;
+    int32_t next_chunk;
+} LogOddsGridJob;
+
+bool LogOddsGrid_init(LogOddsGrid *p_grid, int32_t width, int32_t height, int16_t free_delta, int16_t occupied_delta,
+    int16_t min_log_odds, int16_t max_log_odds)
+{
+    p_grid->log_odds = (int16_t*)calloc((size_t)width * height, sizeof(int16_t));
+    p_grid->scan_flags = (uint8_t*)calloc((size_t)width * height, sizeof(uint8_t));
+    p_grid->width = width;
+    p_grid->height = height;
+    p_grid->free_delta = free_delta;
+    p_grid->occupied_delta = occupied_delta;
+    p_grid->min_log_odds = min_log_odds;
+    p_grid->max_log_odds = max_log_odds;
+    if (!p_grid->log_odds || !p_grid->scan_flags)
+    {
+        LogOddsGrid_destroy(p_grid);
+        return false;
+    }
+    return true;
+}
+
+void LogOddsGrid_destroy(LogOddsGrid *p_grid)
+{
+    free(p_grid->log_odds);
+    free(p_grid->scan_flags);
+    p_grid->log_odds = NULL;
+    p_grid->scan_flags = NULL;
+}
+
+int16_t LogOddsGrid_get(const LogOddsGrid *p_grid, int32_t x, int32_t y)
+{
+    return p_grid->log_odds[y * p_grid->width + x];
+}
+
+/// Flags a cell for the current scan, and remembers it if this worker is the first to flag it.
+static inline void log_odds_grid_flag_cell(LogOddsGridWorker *p_worker, int32_t cell, uint8_t flag)
+{
+    uint8_t old_flags = __atomic_fetch_or(&p_worker->p_grid->scan_flags[cell], flag, __ATOMIC_RELAXED);
+    if (old_flags != 0)
+        return;
+    if (p_worker->cell_count == p_worker->cell_capacity)
+    {
+        int32_t capacity = max(p_worker->cell_capacity * 2, 1024);
+        int32_t *cells = (int32_t*)realloc(p_worker->cells, sizeof(int32_t) * capacity);
+        if (!cells)
+        {
+            p_worker->failed = true;
+            return;
+        }
+        p_worker->cells = cells;
+        p_worker->cell_capacity = capacity;
+    }
+    p_worker->cells[p_worker->cell_count++] = cell;
+}
+
+/// Flags every cell of a span as free. Spans are a single row or column, so the cells are clamped to the grid
+/// once per span instead of once per cell.
+void log_odds_grid_free_span_callback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, void *user_data)
+{
+    LogOddsGridWorker *p_worker = (LogOddsGridWorker*)user_data;
+    const LogOddsGrid *p_grid = p_worker->p_grid;
+    int32_t min_x = max(min(x1, x2), 0);
+    int32_t max_x = min(max(x1, x2), p_grid->width - 1);
+    int32_t min_y = max(min(y1, y2), 0);
+    int32_t max_y = min(max(y1, y2), p_grid->height - 1);
+    for (int32_t y = min_y; y <= max_y; y++)
+    {
+        for (int32_t x = min_x; x <= max_x; x++)
+            log_odds_grid_flag_cell(p_worker, y * p_grid->width + x, LOG_ODDS_GRID_FLAG_FREE);
+    }
+}
+
+void *log_odds_grid_flag_worker(void *p_data)
+{
+    LogOddsGridJob *p_job = (LogOddsGridJob*)p_data;
+    const LogOddsGrid *p_grid = p_job->p_grid;
+    pthread_mutex_lock(&p_job->mutex);
+    LogOddsGridWorker *p_worker = &p_job->workers[p_job->next_worker++];
+    pthread_mutex_unlock(&p_job->mutex);
+    while (true)
+    {
+        pthread_mutex_lock(&p_job->mutex);
+        int32_t chunk = p_job->next_chunk++;
+        pthread_mutex_unlock(&p_job->mutex);
+        int32_t first_beam = chunk * LOG_ODDS_GRID_BEAM_CHUNK_SIZE;
+        if (first_beam >= p_job->beam_count)
+            break;
+
+        int32_t last_beam = min(first_beam + LOG_ODDS_GRID_BEAM_CHUNK_SIZE, p_job->beam_count);
+        for (int32_t i = first_beam; i < last_beam; i++)
+        {
+            LineTraverser_traverse_spans_exclude_endpoints(p_job->origin_x, p_job->origin_y,
+                p_job->hit_x[i], p_job->hit_y[i], p_job->square_width, log_odds_grid_free_span_callback, p_worker);
+            int32_t x1, y1, x2, y2;
+            LineTraverser_get_endpoints(p_job->origin_x, p_job->origin_y, p_job->hit_x[i], p_job->hit_y[i],
+                p_job->square_width, &x1, &y1, &x2, &y2);
+            if (x2 >= 0 && y2 >= 0 && x2 < p_grid->width && y2 < p_grid->height)
+                log_odds_grid_flag_cell(p_worker, y2 * p_grid->width + x2, LOG_ODDS_GRID_FLAG_OCCUPIED);
+        }
+    }
+    return NULL;
+}
+
+void *log_odds_grid_update_worker(void *p_data)
+{
+    LogOddsGridJob *p_job = (LogOddsGridJob*)p_data;
+    LogOddsGrid *p_grid = p_job->p_grid;
+    while (true)
+    {
+        pthread_mutex_lock(&p_job->mutex);
+        int32_t worker = p_job->next_worker++;
+        pthread_mutex_unlock(&p_job->mutex);
+        if (worker >= p_job->worker_count)
+            break;
+
+        // Every cell is in the list of exactly one worker, so the lists can be updated in parallel.
+        const LogOddsGridWorker *p_worker = &p_job->workers[worker];
+        for (int32_t i = 0; i < p_worker->cell_count; i++)
+        {
+            int32_t cell = p_worker->cells[i];
+            int32_t delta = (p_grid->scan_flags[cell] & LOG_ODDS_GRID_FLAG_OCCUPIED) ?
+                p_grid->occupied_delta : p_grid->free_delta;
+            int32_t log_odds = p_grid->log_odds[cell] + delta;
+            p_grid->log_odds[cell] = (int16_t)max(min(log_odds, (int32_t)p_grid->max_log_odds),
+                (int32_t)p_grid->min_log_odds);
+            p_grid->scan_flags[cell] = 0;
+        }
+    }
+    return NULL;
+}
+
+/// Runs a worker function on the calling thread and (thread_count - 1) other threads, and waits for all of them.
+/// If the threads can't be allocated, the calling thread does all of the work.
+void log_odds_grid_run(void *(*worker)(void*), LogOddsGridJob *p_job, int32_t thread_count)
+{
+    int32_t extra_thread_count = thread_count - 1;
+    pthread_t *threads = (pthread_t*)malloc(sizeof(pthread_t) * max(extra_thread_count, 1));
+    int32_t started_count = 0;
+    for (int32_t i = 0; threads && i < extra_thread_count; i++)
+    {
+        if (pthread_create(&threads[started_count], NULL, worker, p_job) == 0)
+            started_count++;
+    }
+    worker(p_job);
+    for (int32_t i = 0; i < started_count; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+}
+
+bool LogOddsGrid_integrate_scan(LogOddsGrid *p_grid, int32_t origin_x, int32_t origin_y,
+    const int32_t *hit_x, const int32_t *hit_y, int32_t beam_count, int32_t square_width, int32_t thread_count)
+{
+    if (beam_count <= 0)
+        return true;
+    int32_t chunk_count = (beam_count + LOG_ODDS_GRID_BEAM_CHUNK_SIZE - 1) / LOG_ODDS_GRID_BEAM_CHUNK_SIZE;
+    thread_count = min(max(thread_count, 1), chunk_count);
+
+    LogOddsGridJob job;
+    job.p_grid = p_grid;
+    job.origin_x = origin_x;
+    job.origin_y = origin_y;
+    job.hit_x = hit_x;
+    job.hit_y = hit_y;
+    job.beam_count = beam_count;
+    job.square_width = square_width;
+    job.workers = (LogOddsGridWorker*)calloc(thread_count, sizeof(LogOddsGridWorker));
+    if (!job.workers)
+        return false;
+    job.worker_count = thread_count;
+    for (int32_t i = 0; i < thread_count; i++)
+        job.workers[i].p_grid = p_grid;
+    pthread_mutex_init(&job.mutex, NULL);
+
+    // First every thread flags the cells of its beams, then the flagged cells are updated and the flags cleared.
+    job.next_worker = 0;
+    job.next_chunk = 0;
+    log_odds_grid_run(log_odds_grid_flag_worker, &job, thread_count);
+    bool success = true;
+    for (int32_t i = 0; i < thread_count; i++)
+        success &= !job.workers[i].failed;
+    if (success)
+    {
+        job.next_worker = 0;
+        log_odds_grid_run(log_odds_grid_update_worker, &job, thread_count);
+    }
+    else
+    {
+        // Some flagged cells are in no list, so the flags are cleared without updating any cell.
+        memset(p_grid->scan_flags, 0, (size_t)p_grid->width * p_grid->height);
+    }
+
+    pthread_mutex_destroy(&job.mutex);
+    for (int32_t i = 0; i < thread_count; i++)
+        free(job.workers[i].cells);
+    free(job.workers);
+    return success;
+}
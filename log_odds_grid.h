@@ -0,0 +1,64 @@
+/// log_odds_grid.h
+/// Provides a log-odds occupancy grid which integrates 2D range scans using multiple threads.
+
+#ifndef LOG_ODDS_GRID_H
+#define LOG_ODDS_GRID_H
+
+#include "line_traverser.h"
+
+/// The number of beams given to a thread at a time.
+#define LOG_ODDS_GRID_BEAM_CHUNK_SIZE 64
+
+/// Occupancy grid where every cell holds the log-odds of being occupied, in fixed point.
+typedef struct
+{
+    int16_t *log_odds;
+    uint8_t *scan_flags;
+    int32_t width, height;
+    int16_t free_delta, occupied_delta;
+    int16_t min_log_odds, max_log_odds;
+} LogOddsGrid;
+
+/// Initializes a LogOddsGrid where every cell has a log-odds of 0.
+/// @param p_grid is a pointer to the grid to initialize.
+/// @param width is the number of cells in a row of the grid.
+/// @param height is the number of rows in the grid.
+/// @param free_delta is added to the log-odds of a cell that a beam goes through.
+/// @param occupied_delta is added to the log-odds of a cell that a beam ends in.
+/// @param min_log_odds is the minimum log-odds of a cell.
+/// @param max_log_odds is the maximum log-odds of a cell.
+/// @returns true if the grid was initialized, false if memory could not be allocated.
+/// @remarks LogOddsGrid_destroy() must be called once the grid is no longer used.
+bool LogOddsGrid_init(LogOddsGrid *p_grid, int32_t width, int32_t height, int16_t free_delta, int16_t occupied_delta,
+    int16_t min_log_odds, int16_t max_log_odds);
+
+/// Frees the memory of a LogOddsGrid.
+/// @param p_grid is a pointer to the grid to free.
+void LogOddsGrid_destroy(LogOddsGrid *p_grid);
+
+/// Gets the log-odds of a cell.
+/// @param p_grid is a pointer to the grid.
+/// @param x is the x coordinate of the cell.
+/// @param y is the y coordinate of the cell.
+/// @returns the log-odds of the cell.
+int16_t LogOddsGrid_get(const LogOddsGrid *p_grid, int32_t x, int32_t y);
+
+/// Integrates a scan of beams from one sensor origin into the grid.
+/// @param p_grid is a pointer to the grid to update.
+/// @param origin_x is the x coordinate of the sensor, in the coordinates of the beams.
+/// @param origin_y is the y coordinate of the sensor, in the coordinates of the beams.
+/// @param hit_x is an array of the x coordinates where the beams hit something.
+/// @param hit_y is an array of the y coordinates where the beams hit something.
+/// @param beam_count is the number of beams in hit_x and hit_y.
+/// @param square_width is the width of a cell, in the coordinates of the beams.
+/// @param thread_count is the number of threads to use, including the calling thread.
+/// @returns true if the scan was integrated, false if memory could not be allocated, in which case the grid is
+/// left unchanged.
+/// @remarks Every cell traversed by LineTraverser_traverse_exclude_endpoints() for a beam is free, and the ending
+/// cell from LineTraverser_get_endpoints() is occupied. Each cell is updated at most once per scan, no matter
+/// how many beams traverse it: with occupied_delta if any beam ends in it, otherwise with free_delta.
+/// Cells outside of the grid are ignored.
+bool LogOddsGrid_integrate_scan(LogOddsGrid *p_grid, int32_t origin_x, int32_t origin_y,
+    const int32_t *hit_x, const int32_t *hit_y, int32_t beam_count, int32_t square_width, int32_t thread_count);
+
+#endif // LOG_ODDS_GRID_H
@@ -0,0 +1,155 @@
+/// occupancy_pyramid.c
+/// Provides a mip-pyramid over an occupancy grid, for casting lines that skip over empty space.
+
+#include "occupancy_pyramid.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/// Recomputes one cell of a level from the 2x2 cells it covers in the level below.
+void occupancy_pyramid_update_cell(OccupancyPyramid *p_pyramid, int32_t level, int32_t x, int32_t y)
+{
+    const uint8_t *child = p_pyramid->levels[level - 1];
+    int32_t child_width = p_pyramid->level_widths[level - 1];
+    int32_t child_height = p_pyramid->level_heights[level - 1];
+    int32_t child_x = x * 2;
+    int32_t child_y = y * 2;
+    uint8_t occupied = child[child_y * child_width + child_x];
+    if (child_x + 1 < child_width)
+        occupied |= child[child_y * child_width + child_x + 1];
+    if (child_y + 1 < child_height)
+    {
+        occupied |= child[(child_y + 1) * child_width + child_x];
+        if (child_x + 1 < child_width)
+            occupied |= child[(child_y + 1) * child_width + child_x + 1];
+    }
+    p_pyramid->levels[level][y * p_pyramid->level_widths[level] + x] = occupied;
+}
+
+bool OccupancyPyramid_init(OccupancyPyramid *p_pyramid, const uint8_t *occupancy, int32_t width, int32_t height)
+{
+    memset(p_pyramid, 0, sizeof(OccupancyPyramid));
+    int32_t level_width = max(width, 1);
+    int32_t level_height = max(height, 1);
+    while (true)
+    {
+        int32_t level = p_pyramid->level_count;
+        p_pyramid->levels[level] = (uint8_t*)calloc((size_t)level_width * level_height, 1);
+        if (!p_pyramid->levels[level])
+        {
+            OccupancyPyramid_destroy(p_pyramid);
+            return false;
+        }
+        p_pyramid->level_widths[level] = level_width;
+        p_pyramid->level_heights[level] = level_height;
+        p_pyramid->level_count++;
+        if (level == 0)
+        {
+            for (int64_t i = 0; i < (int64_t)width * height; i++)
+                p_pyramid->levels[0][i] = occupancy[i] ? 1 : 0;
+        }
+        else
+        {
+            for (int32_t y = 0; y < level_height; y++)
+            {
+                for (int32_t x = 0; x < level_width; x++)
+                    occupancy_pyramid_update_cell(p_pyramid, level, x, y);
+            }
+        }
+        if (level_width == 1 && level_height == 1)
+            break;
+        level_width = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+    return true;
+}
+
+void OccupancyPyramid_destroy(OccupancyPyramid *p_pyramid)
+{
+    for (int32_t level = 0; level < p_pyramid->level_count; level++)
+        free(p_pyramid->levels[level]);
+    p_pyramid->level_count = 0;
+}
+
+void OccupancyPyramid_set(OccupancyPyramid *p_pyramid, int32_t x, int32_t y, bool occupied)
+{
+    p_pyramid->levels[0][y * p_pyramid->level_widths[0] + x] = occupied ? 1 : 0;
+    for (int32_t level = 1; level < p_pyramid->level_count; level++)
+    {
+        x /= 2;
+        y /= 2;
+        occupancy_pyramid_update_cell(p_pyramid, level, x, y);
+    }
+}
+
+/// Tests if a cell of a level is occupied, where cells outside of the level are empty.
+static inline bool occupancy_pyramid_level_occupied(const OccupancyPyramid *p_pyramid, int32_t level,
+    int32_t x, int32_t y)
+{
+    if (x < 0 || y < 0 || x >= p_pyramid->level_widths[level] || y >= p_pyramid->level_heights[level])
+        return false;
+    return p_pyramid->levels[level][y * p_pyramid->level_widths[level] + x] != 0;
+}
+
+bool OccupancyPyramid_is_occupied(const OccupancyPyramid *p_pyramid, int32_t x, int32_t y)
+{
+    return occupancy_pyramid_level_occupied(p_pyramid, 0, x, y);
+}
+
+bool OccupancyPyramid_cast(const OccupancyPyramid *p_pyramid, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t *out_x, int32_t *out_y)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int32_t x, y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        if (occupancy_pyramid_level_occupied(p_pyramid, 0, x, y))
+        {
+            *out_x = x;
+            *out_y = y;
+            return true;
+        }
+        if (LineTraverser_is_end(&traverser))
+            return false;
+
+        // Find the coarsest level where the cell containing (x, y) is empty.
+        int32_t level = 1;
+        while (level < p_pyramid->level_count &&
+            !occupancy_pyramid_level_occupied(p_pyramid, level, x >> level, y >> level))
+            level++;
+        level--;
+        if (level == 0)
+        {
+            LineTraverser_next(&traverser);
+            continue;
+        }
+
+        // Every cell in the empty block is skipped, and the line continues at the first cell past the block,
+        // which is the first cell either in the column or in the row just outside of the block.
+        // Blocks of the top levels reach past 32 bits, and the line never reaches a column or row out there.
+        int64_t block_size = (int64_t)1 << level;
+        int64_t block_min_x = (int64_t)(x >> level) * block_size;
+        int64_t block_min_y = (int64_t)(y >> level) * block_size;
+        int64_t exit_x = (traverser.dx_x > 0) ? (block_min_x + block_size) : (block_min_x - 1);
+        int64_t exit_y = (traverser.dy_y > 0) ? (block_min_y + block_size) : (block_min_y - 1);
+        LineTraverser column_traverser = traverser;
+        LineTraverser row_traverser = traverser;
+        int64_t column_steps = (exit_x >= INT32_MIN && exit_x <= INT32_MAX) ?
+            LineTraverser_seek_column(&column_traverser, (int32_t)exit_x) : -1;
+        int64_t row_steps = (exit_y >= INT32_MIN && exit_y <= INT32_MAX) ?
+            LineTraverser_seek_row(&row_traverser, (int32_t)exit_y) : -1;
+        if (column_steps < 0 && row_steps < 0)
+            return false;
+        if (row_steps < 0 || (column_steps >= 0 && column_steps <= row_steps))
+            traverser = column_traverser;
+        else
+            traverser = row_traverser;
+    }
+}
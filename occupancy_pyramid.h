@@ -0,0 +1,67 @@
+/// occupancy_pyramid.h
+/// Provides a mip-pyramid over an occupancy grid, for casting lines that skip over empty space.
+
+#ifndef OCCUPANCY_PYRAMID_H
+#define OCCUPANCY_PYRAMID_H
+
+#include "line_traverser.h"
+
+/// The maximum number of levels in an OccupancyPyramid, including the full resolution grid.
+#define OCCUPANCY_PYRAMID_MAX_LEVELS 32
+
+/// Pyramid of occupancy grids. Level 0 is the full resolution grid, and every cell of level l + 1 is occupied
+/// if any of the 2x2 cells it covers in level l is occupied. The last level is a single cell.
+typedef struct
+{
+    uint8_t *levels[OCCUPANCY_PYRAMID_MAX_LEVELS];
+    int32_t level_widths[OCCUPANCY_PYRAMID_MAX_LEVELS];
+    int32_t level_heights[OCCUPANCY_PYRAMID_MAX_LEVELS];
+    int32_t level_count;
+} OccupancyPyramid;
+
+/// Builds an OccupancyPyramid from an occupancy grid.
+/// @param p_pyramid is a pointer to the pyramid to build.
+/// @param occupancy is the row-major occupancy grid, where a non-zero value is an occupied cell.
+/// @param width is the number of cells in a row of the occupancy grid.
+/// @param height is the number of rows in the occupancy grid.
+/// @returns true if the pyramid was built, false if memory could not be allocated.
+/// @remarks The occupancy grid is copied, so it can be freed afterwards.
+/// OccupancyPyramid_destroy() must be called once the pyramid is no longer used.
+bool OccupancyPyramid_init(OccupancyPyramid *p_pyramid, const uint8_t *occupancy, int32_t width, int32_t height);
+
+/// Frees the memory of an OccupancyPyramid.
+/// @param p_pyramid is a pointer to the pyramid to free.
+void OccupancyPyramid_destroy(OccupancyPyramid *p_pyramid);
+
+/// Sets one cell of the full resolution grid, and updates the levels above it.
+/// @param p_pyramid is a pointer to the pyramid to update.
+/// @param x is the x coordinate of the cell.
+/// @param y is the y coordinate of the cell.
+/// @param occupied is true if the cell is occupied.
+void OccupancyPyramid_set(OccupancyPyramid *p_pyramid, int32_t x, int32_t y, bool occupied);
+
+/// Tests if a cell of the full resolution grid is occupied.
+/// @param p_pyramid is a pointer to the pyramid to test.
+/// @param x is the x coordinate of the cell.
+/// @param y is the y coordinate of the cell.
+/// @returns true if the cell is occupied. Cells outside of the grid are never occupied.
+bool OccupancyPyramid_is_occupied(const OccupancyPyramid *p_pyramid, int32_t x, int32_t y);
+
+/// Finds the first occupied grid cell that a line traverses.
+/// @param p_pyramid is a pointer to the pyramid to cast the line through.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param square_width is the width of a cell of the full resolution grid, in the coordinates of the line.
+/// @param out_x is a pointer to write the x coordinate of the first occupied cell to.
+/// @param out_y is a pointer to write the y coordinate of the first occupied cell to.
+/// @returns true if the line traverses an occupied cell, false otherwise.
+/// @remarks The hit is exactly the first occupied cell that LineTraverser_next() would reach from
+/// LineTraverser_init(), including both endpoints. Whenever the line is in an empty cell of a coarser level,
+/// the whole block of full resolution cells under it is skipped at once with LineTraverser_seek_column()
+/// and LineTraverser_seek_row(), so long stretches of empty space take a few steps instead of one per cell.
+bool OccupancyPyramid_cast(const OccupancyPyramid *p_pyramid, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t square_width, int32_t *out_x, int32_t *out_y);
+
+#endif // OCCUPANCY_PYRAMID_H
@@ -0,0 +1,177 @@
+/// segment_grid.c
+/// Provides a uniform grid spatial index of line segments, built by traversing the segments over the grid.
+
+#include "segment_grid.h"
+#include "line_bounder.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/// Adds a segment to the cells it traverses. If segment_ids is null, the cells count the segment instead.
+void segment_grid_add_segment(SegmentGrid *p_grid, int32_t segment_id, int64_t *cell_ends, int32_t *segment_ids)
+{
+    LineTraverser traverser = LineTraverser_init(p_grid->x1[segment_id] - p_grid->origin_x,
+        p_grid->y1[segment_id] - p_grid->origin_y, p_grid->x2[segment_id] - p_grid->origin_x,
+        p_grid->y2[segment_id] - p_grid->origin_y, p_grid->square_width);
+    while (true)
+    {
+        int32_t x, y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        int64_t cell = (int64_t)y * p_grid->width + x;
+        if (segment_ids)
+            segment_ids[cell_ends[cell]] = segment_id;
+        cell_ends[cell]++;
+        if (LineTraverser_is_end(&traverser))
+            break;
+        LineTraverser_next(&traverser);
+    }
+}
+
+bool SegmentGrid_init(SegmentGrid *p_grid, const int32_t *x1, const int32_t *y1, const int32_t *x2,
+    const int32_t *y2, int32_t segment_count, int32_t square_width)
+{
+    memset(p_grid, 0, sizeof(SegmentGrid));
+    p_grid->x1 = x1;
+    p_grid->y1 = y1;
+    p_grid->x2 = x2;
+    p_grid->y2 = y2;
+    p_grid->segment_count = segment_count;
+    p_grid->square_width = square_width;
+    int32_t max_x = 0, max_y = 0;
+    for (int32_t i = 0; i < segment_count; i++)
+    {
+        if (i == 0)
+        {
+            p_grid->origin_x = max_x = x1[0];
+            p_grid->origin_y = max_y = y1[0];
+        }
+        p_grid->origin_x = min(p_grid->origin_x, min(x1[i], x2[i]));
+        p_grid->origin_y = min(p_grid->origin_y, min(y1[i], y2[i]));
+        max_x = max(max_x, max(x1[i], x2[i]));
+        max_y = max(max_y, max(y1[i], y2[i]));
+    }
+    // The segments are traversed relative to the origin, so their coordinates are never negative.
+    int64_t span_x = (int64_t)max_x - p_grid->origin_x;
+    int64_t span_y = (int64_t)max_y - p_grid->origin_y;
+    if (span_x > INT32_MAX || span_y > INT32_MAX)
+        return false;
+    p_grid->width = (int32_t)(span_x / square_width + 1);
+    p_grid->height = (int32_t)(span_y / square_width + 1);
+    int64_t cell_count = (int64_t)p_grid->width * p_grid->height;
+
+    // Count the segments of every cell, then turn the counts into offsets and fill in the ids.
+    p_grid->cell_offsets = (int64_t*)calloc((size_t)cell_count + 1, sizeof(int64_t));
+    if (!p_grid->cell_offsets)
+        return false;
+    int64_t *cell_ends = p_grid->cell_offsets + 1;
+    for (int32_t i = 0; i < segment_count; i++)
+        segment_grid_add_segment(p_grid, i, cell_ends, NULL);
+    for (int64_t cell = 1; cell < cell_count; cell++)
+        cell_ends[cell] += cell_ends[cell - 1];
+    p_grid->segment_ids = (int32_t*)malloc(sizeof(int32_t) * max(p_grid->cell_offsets[cell_count], 1));
+    if (!p_grid->segment_ids)
+    {
+        SegmentGrid_destroy(p_grid);
+        return false;
+    }
+    // Each cell is filled from its offset, which leaves cell_ends[cell - 1] at the end of the cell.
+    cell_ends = p_grid->cell_offsets;
+    for (int32_t i = 0; i < segment_count; i++)
+        segment_grid_add_segment(p_grid, i, cell_ends, p_grid->segment_ids);
+    memmove(p_grid->cell_offsets + 1, p_grid->cell_offsets, sizeof(int64_t) * cell_count);
+    p_grid->cell_offsets[0] = 0;
+    return true;
+}
+
+void SegmentGrid_destroy(SegmentGrid *p_grid)
+{
+    free(p_grid->cell_offsets);
+    free(p_grid->segment_ids);
+    memset(p_grid, 0, sizeof(SegmentGrid));
+}
+
+int64_t SegmentGrid_query_cell(const SegmentGrid *p_grid, int32_t cell_x, int32_t cell_y,
+    const int32_t **out_segment_ids)
+{
+    *out_segment_ids = p_grid->segment_ids;
+    if (cell_x < 0 || cell_y < 0 || cell_x >= p_grid->width || cell_y >= p_grid->height)
+        return 0;
+    int64_t cell = (int64_t)cell_y * p_grid->width + cell_x;
+    *out_segment_ids = p_grid->segment_ids + p_grid->cell_offsets[cell];
+    return p_grid->cell_offsets[cell + 1] - p_grid->cell_offsets[cell];
+}
+
+/// Gets the cell of the grid that a coordinate is in, which may be outside of the grid.
+int64_t segment_grid_cell_of(int32_t value, int32_t origin, int32_t square_width)
+{
+    int64_t offset = (int64_t)value - origin;
+    return (offset >= 0) ? (offset / square_width) : -((-offset + square_width - 1) / square_width);
+}
+
+int segment_grid_compare_ids(const void *p_a, const void *p_b)
+{
+    int32_t a = *(const int32_t*)p_a;
+    int32_t b = *(const int32_t*)p_b;
+    return (a > b) - (a < b);
+}
+
+bool SegmentGrid_query_rect(const SegmentGrid *p_grid, int32_t bounds_min_x, int32_t bounds_min_y,
+    int32_t bounds_max_x, int32_t bounds_max_y, SegmentGridCallback callback, void *user_data)
+{
+    int64_t cell_min_x = max(segment_grid_cell_of(bounds_min_x, p_grid->origin_x, p_grid->square_width), 0);
+    int64_t cell_min_y = max(segment_grid_cell_of(bounds_min_y, p_grid->origin_y, p_grid->square_width), 0);
+    int64_t cell_max_x = min(segment_grid_cell_of(bounds_max_x, p_grid->origin_x, p_grid->square_width),
+        (int64_t)p_grid->width - 1);
+    int64_t cell_max_y = min(segment_grid_cell_of(bounds_max_y, p_grid->origin_y, p_grid->square_width),
+        (int64_t)p_grid->height - 1);
+    if (p_grid->segment_count == 0 || cell_min_x > cell_max_x || cell_min_y > cell_max_y)
+        return true;
+
+    // The cells of a row of the region are next to each other, so their ids are one slice of segment_ids.
+    int64_t candidate_count = 0;
+    for (int64_t y = cell_min_y; y <= cell_max_y; y++)
+        candidate_count += p_grid->cell_offsets[y * p_grid->width + cell_max_x + 1] -
+            p_grid->cell_offsets[y * p_grid->width + cell_min_x];
+    int32_t *candidates = (int32_t*)malloc(sizeof(int32_t) * max(candidate_count, 1));
+    if (!candidates)
+        return false;
+    candidate_count = 0;
+    for (int64_t y = cell_min_y; y <= cell_max_y; y++)
+    {
+        int64_t begin = p_grid->cell_offsets[y * p_grid->width + cell_min_x];
+        int64_t end = p_grid->cell_offsets[y * p_grid->width + cell_max_x + 1];
+        memcpy(candidates + candidate_count, p_grid->segment_ids + begin, sizeof(int32_t) * (end - begin));
+        candidate_count += end - begin;
+    }
+    // A segment is only in a cell once, so there are no duplicates unless several cells are overlapped.
+    if (cell_min_x != cell_max_x || cell_min_y != cell_max_y)
+        qsort(candidates, (size_t)candidate_count, sizeof(int32_t), segment_grid_compare_ids);
+
+    for (int64_t i = 0; i < candidate_count; i++)
+    {
+        int32_t id = candidates[i];
+        if (i > 0 && id == candidates[i - 1])
+            continue;
+        int32_t x1 = p_grid->x1[id], y1 = p_grid->y1[id];
+        int32_t x2 = p_grid->x2[id], y2 = p_grid->y2[id];
+        bool inside;
+        if (x1 == x2 && y1 == y2)
+            inside = x1 >= bounds_min_x && x1 <= bounds_max_x && y1 >= bounds_min_y && y1 <= bounds_max_y;
+        else
+        {
+            int64_t bounded_x1, bounded_y1, bounded_x2, bounded_y2;
+            inside = line_bound_inside_rect64(x1, y1, x2, y2, bounds_min_x, bounds_min_y, bounds_max_x, bounds_max_y,
+                &bounded_x1, &bounded_y1, &bounded_x2, &bounded_y2);
+        }
+        if (inside)
+            callback(id, user_data);
+    }
+    free(candidates);
+    return true;
+}
@@ -0,0 +1,75 @@
+/// segment_grid.h
+/// Provides a uniform grid spatial index of line segments, built by traversing the segments over the grid.
+
+#ifndef SEGMENT_GRID_H
+#define SEGMENT_GRID_H
+
+#include "line_traverser.h"
+
+/// Uniform grid over a set of line segments, in compressed sparse row layout. The ids of the segments that
+/// traverse cell (x, y) are segment_ids[cell_offsets[i]] to segment_ids[cell_offsets[i + 1] - 1],
+/// where i = y * width + x, in increasing order.
+typedef struct
+{
+    const int32_t *x1;
+    const int32_t *y1;
+    const int32_t *x2;
+    const int32_t *y2;
+    int32_t segment_count;
+    int64_t *cell_offsets;
+    int32_t *segment_ids;
+    int32_t origin_x, origin_y;
+    int32_t square_width;
+    int32_t width, height;
+} SegmentGrid;
+
+/// Called with the id of each segment found by a query.
+/// @param segment_id is the index of the segment in the arrays the grid was built from.
+/// @param user_data is the user data given to the query.
+typedef void (*SegmentGridCallback)(int32_t segment_id, void *user_data);
+
+/// Builds a SegmentGrid over line segments. The grid covers the bounding box of all of the segments,
+/// and every segment is added to each cell that LineTraverser_traverse_include_endpoints() traverses.
+/// @param p_grid is a pointer to the grid to build.
+/// @param x1 is an array of the 1st x points of the segments.
+/// @param y1 is an array of the 1st y points of the segments.
+/// @param x2 is an array of the 2nd x points of the segments.
+/// @param y2 is an array of the 2nd y points of the segments.
+/// @param segment_count is the number of segments.
+/// @param square_width is the width of a cell of the grid, in the coordinates of the segments.
+/// @returns true if the grid was built, false if memory could not be allocated.
+/// @remarks The segment arrays are not copied, and must be kept until the grid is destroyed.
+/// SegmentGrid_destroy() must be called once the grid is no longer used.
+bool SegmentGrid_init(SegmentGrid *p_grid, const int32_t *x1, const int32_t *y1, const int32_t *x2,
+    const int32_t *y2, int32_t segment_count, int32_t square_width);
+
+/// Frees the memory of a SegmentGrid.
+/// @param p_grid is a pointer to the grid to free.
+void SegmentGrid_destroy(SegmentGrid *p_grid);
+
+/// Gets the segments that traverse a cell of the grid.
+/// @param p_grid is a pointer to the grid.
+/// @param cell_x is the x coordinate of the cell.
+/// @param cell_y is the y coordinate of the cell.
+/// @param out_segment_ids is a pointer to write a pointer to the ids of the segments to. The ids are in
+/// increasing order, and belong to the grid.
+/// @returns the number of segments that traverse the cell. Cells outside of the grid have no segments.
+int64_t SegmentGrid_query_cell(const SegmentGrid *p_grid, int32_t cell_x, int32_t cell_y,
+    const int32_t **out_segment_ids);
+
+/// Finds the segments that are inside of a rectangle region.
+/// @param p_grid is a pointer to the grid.
+/// @param bounds_min_x is the inclusive minimum x value of the region.
+/// @param bounds_min_y is the inclusive minimum y value of the region.
+/// @param bounds_max_x is the inclusive maximum x value of the region.
+/// @param bounds_max_y is the inclusive maximum y value of the region.
+/// @param callback is called once for each segment inside the region, in increasing order of id.
+/// @param user_data is passed to the callback.
+/// @returns true if the query was done, false if memory could not be allocated.
+/// @remarks The segments from the cells overlapping the region are refined like line_bound_inside_rect(),
+/// so a segment which only touches the region at a single point is not inside it. A segment of zero length is
+/// inside if its point is.
+bool SegmentGrid_query_rect(const SegmentGrid *p_grid, int32_t bounds_min_x, int32_t bounds_min_y,
+    int32_t bounds_max_x, int32_t bounds_max_y, SegmentGridCallback callback, void *user_data);
+
+#endif // SEGMENT_GRID_H
@@ -0,0 +1,421 @@
+/// segment_intersections.c
+/// Provides functions for finding all pairs of intersecting line segments using multiple threads.
+
+#include "segment_intersections.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+__extension__ typedef __int128 segment_intersections_int128;
+
+/// A segment which traverses a grid cell.
+typedef struct
+{
+    int64_t cell;
+    int32_t segment_id;
+} SegmentIntersectionsEntry;
+
+/// The cells that one thread's segments traverse, in hash buckets, and the intersecting pairs it found.
+typedef struct
+{
+    SegmentIntersectionsEntry **bucket_entries;
+    int64_t *bucket_counts;
+    int64_t *bucket_capacities;
+    SegmentIntersectionsEntry *scratch;
+    int64_t scratch_capacity;
+    SegmentIntersectionPair *pairs;
+    int64_t pair_count;
+    int64_t pair_capacity;
+    bool failed;
+} SegmentIntersectionsWorker;
+
+typedef struct
+{
+    const int32_t *x1;
+    const int32_t *y1;
+    const int32_t *x2;
+    const int32_t *y2;
+    int32_t segment_count;
+    int32_t square_width;
+    int32_t origin_x, origin_y;
+    int64_t width, height;
+    SegmentIntersectionsWorker *workers;
+    int32_t worker_count;
+    int32_t bucket_count;
+    pthread_mutex_t mutex;
+    int32_t next_worker;
+    int32_t next_chunk;
+    int32_t next_bucket;
+} SegmentIntersectionsJob;
+
+/// Gets the sign of the cross product of (b - a) and (c - a).
+static inline int32_t segment_intersections_orientation(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+    int32_t cx, int32_t cy)
+{
+    segment_intersections_int128 cross = (segment_intersections_int128)((int64_t)bx - ax) * ((int64_t)cy - ay) -
+        (segment_intersections_int128)((int64_t)by - ay) * ((int64_t)cx - ax);
+    return (cross > 0) - (cross < 0);
+}
+
+/// Tests if a point that is collinear with a segment is on it.
+static inline bool segment_intersections_on_segment(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+    int32_t cx, int32_t cy)
+{
+    return cx >= min(ax, bx) && cx <= max(ax, bx) && cy >= min(ay, by) && cy <= max(ay, by);
+}
+
+bool SegmentIntersections_intersect(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t x3, int32_t y3, int32_t x4, int32_t y4)
+{
+    int32_t o1 = segment_intersections_orientation(x3, y3, x4, y4, x1, y1);
+    int32_t o2 = segment_intersections_orientation(x3, y3, x4, y4, x2, y2);
+    int32_t o3 = segment_intersections_orientation(x1, y1, x2, y2, x3, y3);
+    int32_t o4 = segment_intersections_orientation(x1, y1, x2, y2, x4, y4);
+    if (o1 * o2 < 0 && o3 * o4 < 0)
+        return true;
+    return (o1 == 0 && segment_intersections_on_segment(x3, y3, x4, y4, x1, y1)) ||
+        (o2 == 0 && segment_intersections_on_segment(x3, y3, x4, y4, x2, y2)) ||
+        (o3 == 0 && segment_intersections_on_segment(x1, y1, x2, y2, x3, y3)) ||
+        (o4 == 0 && segment_intersections_on_segment(x1, y1, x2, y2, x4, y4));
+}
+
+/// Grows an array to hold at least one more element. Returns false if memory could not be allocated.
+bool segment_intersections_reserve(void **p_array, int64_t *p_capacity, int64_t count, size_t element_size)
+{
+    if (count < *p_capacity)
+        return true;
+    int64_t capacity = max(*p_capacity * 2, (int64_t)1024);
+    void *array = realloc(*p_array, element_size * capacity);
+    if (!array)
+        return false;
+    *p_array = array;
+    *p_capacity = capacity;
+    return true;
+}
+
+/// Adds a segment to the hash bucket of a cell. Cells outside of the grid are ignored.
+static inline void segment_intersections_add_cell(const SegmentIntersectionsJob *p_job,
+    SegmentIntersectionsWorker *p_worker, int32_t x, int32_t y, int32_t segment_id)
+{
+    if (x < 0 || y < 0 || x >= p_job->width || y >= p_job->height)
+        return;
+    int64_t cell = y * p_job->width + x;
+    int32_t bucket = (int32_t)((((uint64_t)cell * 0x9E3779B97F4A7C15ull) >> 32) % (uint64_t)p_job->bucket_count);
+    if (!segment_intersections_reserve((void**)&p_worker->bucket_entries[bucket], &p_worker->bucket_capacities[bucket],
+        p_worker->bucket_counts[bucket], sizeof(SegmentIntersectionsEntry)))
+    {
+        p_worker->failed = true;
+        return;
+    }
+    SegmentIntersectionsEntry *p_entry = &p_worker->bucket_entries[bucket][p_worker->bucket_counts[bucket]++];
+    p_entry->cell = cell;
+    p_entry->segment_id = segment_id;
+}
+
+/// Adds a segment to every cell whose closed square it touches.
+/// The traversal alone gives each point on a cell boundary to only one of the cells, and which one depends on
+/// the direction of the segment, so two segments meeting on a boundary could otherwise share no cell.
+void segment_intersections_add_segment(const SegmentIntersectionsJob *p_job, SegmentIntersectionsWorker *p_worker,
+    int32_t segment_id)
+{
+    int32_t x1 = p_job->x1[segment_id] - p_job->origin_x;
+    int32_t y1 = p_job->y1[segment_id] - p_job->origin_y;
+    int32_t x2 = p_job->x2[segment_id] - p_job->origin_x;
+    int32_t y2 = p_job->y2[segment_id] - p_job->origin_y;
+    int32_t square_width = p_job->square_width;
+    // A segment along a grid line is also on the cells across the line.
+    bool on_column_boundary = x1 == x2 && x1 % square_width == 0;
+    bool on_row_boundary = y1 == y2 && y1 % square_width == 0;
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int32_t x, y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        segment_intersections_add_cell(p_job, p_worker, x, y, segment_id);
+        if (on_column_boundary)
+            segment_intersections_add_cell(p_job, p_worker, x1 / square_width - 1, y, segment_id);
+        if (on_row_boundary)
+            segment_intersections_add_cell(p_job, p_worker, x, y1 / square_width - 1, segment_id);
+        if (LineTraverser_is_end(&traverser))
+            break;
+        // A diagonal step goes exactly through a corner, which is also on the two cells beside it.
+        if (traverser.clockwiseness == 0)
+        {
+            segment_intersections_add_cell(p_job, p_worker, x + traverser.dx_x, y, segment_id);
+            segment_intersections_add_cell(p_job, p_worker, x, y + traverser.dy_y, segment_id);
+        }
+        LineTraverser_next(&traverser);
+    }
+    // An endpoint on a boundary is on the cells on both sides of it.
+    for (int32_t i = 0; i < 2; i++)
+    {
+        int32_t x = (i == 0) ? x1 : x2;
+        int32_t y = (i == 0) ? y1 : y2;
+        int32_t cell_x = x / square_width;
+        int32_t cell_y = y / square_width;
+        bool x_on_boundary = x % square_width == 0;
+        bool y_on_boundary = y % square_width == 0;
+        segment_intersections_add_cell(p_job, p_worker, cell_x, cell_y, segment_id);
+        if (x_on_boundary)
+            segment_intersections_add_cell(p_job, p_worker, cell_x - 1, cell_y, segment_id);
+        if (y_on_boundary)
+            segment_intersections_add_cell(p_job, p_worker, cell_x, cell_y - 1, segment_id);
+        if (x_on_boundary && y_on_boundary)
+            segment_intersections_add_cell(p_job, p_worker, cell_x - 1, cell_y - 1, segment_id);
+    }
+}
+
+void *segment_intersections_bin_worker(void *p_data)
+{
+    SegmentIntersectionsJob *p_job = (SegmentIntersectionsJob*)p_data;
+    pthread_mutex_lock(&p_job->mutex);
+    SegmentIntersectionsWorker *p_worker = &p_job->workers[p_job->next_worker++];
+    pthread_mutex_unlock(&p_job->mutex);
+    while (true)
+    {
+        pthread_mutex_lock(&p_job->mutex);
+        int32_t chunk = p_job->next_chunk++;
+        pthread_mutex_unlock(&p_job->mutex);
+        int32_t first_segment = chunk * SEGMENT_INTERSECTIONS_CHUNK_SIZE;
+        if (first_segment >= p_job->segment_count)
+            break;
+
+        int32_t last_segment = min(first_segment + SEGMENT_INTERSECTIONS_CHUNK_SIZE, p_job->segment_count);
+        for (int32_t i = first_segment; i < last_segment; i++)
+            segment_intersections_add_segment(p_job, p_worker, i);
+    }
+    return NULL;
+}
+
+int segment_intersections_compare_entries(const void *p_a, const void *p_b)
+{
+    const SegmentIntersectionsEntry *p_entry_a = (const SegmentIntersectionsEntry*)p_a;
+    const SegmentIntersectionsEntry *p_entry_b = (const SegmentIntersectionsEntry*)p_b;
+    if (p_entry_a->cell != p_entry_b->cell)
+        return (p_entry_a->cell > p_entry_b->cell) ? 1 : -1;
+    return (p_entry_a->segment_id > p_entry_b->segment_id) - (p_entry_a->segment_id < p_entry_b->segment_id);
+}
+
+int segment_intersections_compare_pairs(const void *p_a, const void *p_b)
+{
+    const SegmentIntersectionPair *p_pair_a = (const SegmentIntersectionPair*)p_a;
+    const SegmentIntersectionPair *p_pair_b = (const SegmentIntersectionPair*)p_b;
+    if (p_pair_a->first_id != p_pair_b->first_id)
+        return (p_pair_a->first_id > p_pair_b->first_id) ? 1 : -1;
+    return (p_pair_a->second_id > p_pair_b->second_id) - (p_pair_a->second_id < p_pair_b->second_id);
+}
+
+void *segment_intersections_pair_worker(void *p_data)
+{
+    SegmentIntersectionsJob *p_job = (SegmentIntersectionsJob*)p_data;
+    pthread_mutex_lock(&p_job->mutex);
+    SegmentIntersectionsWorker *p_worker = &p_job->workers[p_job->next_worker++];
+    pthread_mutex_unlock(&p_job->mutex);
+    while (true)
+    {
+        pthread_mutex_lock(&p_job->mutex);
+        int32_t bucket = p_job->next_bucket++;
+        pthread_mutex_unlock(&p_job->mutex);
+        if (bucket >= p_job->bucket_count)
+            break;
+
+        // Gather the bucket from every worker, and sort it so the segments of each cell are together.
+        int64_t entry_count = 0;
+        for (int32_t i = 0; i < p_job->worker_count; i++)
+            entry_count += p_job->workers[i].bucket_counts[bucket];
+        if (entry_count > p_worker->scratch_capacity)
+        {
+            free(p_worker->scratch);
+            p_worker->scratch = (SegmentIntersectionsEntry*)malloc(sizeof(SegmentIntersectionsEntry) * entry_count);
+            p_worker->scratch_capacity = p_worker->scratch ? entry_count : 0;
+            if (!p_worker->scratch)
+            {
+                p_worker->failed = true;
+                continue;
+            }
+        }
+        entry_count = 0;
+        for (int32_t i = 0; i < p_job->worker_count; i++)
+        {
+            // An empty bucket may never have been allocated, and memcpy() must not be given NULL.
+            if (p_job->workers[i].bucket_counts[bucket] == 0)
+                continue;
+            memcpy(p_worker->scratch + entry_count, p_job->workers[i].bucket_entries[bucket],
+                sizeof(SegmentIntersectionsEntry) * p_job->workers[i].bucket_counts[bucket]);
+            entry_count += p_job->workers[i].bucket_counts[bucket];
+        }
+        qsort(p_worker->scratch, (size_t)entry_count, sizeof(SegmentIntersectionsEntry),
+            segment_intersections_compare_entries);
+
+        // A segment can be added to a cell more than once, where it touches the cell in several ways.
+        SegmentIntersectionsEntry *entries = p_worker->scratch;
+        int64_t unique_count = 0;
+        for (int64_t i = 0; i < entry_count; i++)
+        {
+            if (unique_count == 0 || segment_intersections_compare_entries(&entries[unique_count - 1], &entries[i]))
+                entries[unique_count++] = entries[i];
+        }
+        entry_count = unique_count;
+        for (int64_t begin = 0, end = 0; begin < entry_count; begin = end)
+        {
+            while (end < entry_count && entries[end].cell == entries[begin].cell)
+                end++;
+            for (int64_t i = begin; i < end; i++)
+            {
+                int32_t a = entries[i].segment_id;
+                for (int64_t j = i + 1; j < end; j++)
+                {
+                    int32_t b = entries[j].segment_id;
+                    if (!SegmentIntersections_intersect(p_job->x1[a], p_job->y1[a], p_job->x2[a],
+                        p_job->y2[a], p_job->x1[b], p_job->y1[b], p_job->x2[b], p_job->y2[b]))
+                        continue;
+                    if (!segment_intersections_reserve((void**)&p_worker->pairs, &p_worker->pair_capacity,
+                        p_worker->pair_count, sizeof(SegmentIntersectionPair)))
+                    {
+                        p_worker->failed = true;
+                        continue;
+                    }
+                    p_worker->pairs[p_worker->pair_count].first_id = a;
+                    p_worker->pairs[p_worker->pair_count].second_id = b;
+                    p_worker->pair_count++;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+/// Runs a worker function on the calling thread and (thread_count - 1) other threads, and waits for all of them.
+/// If the threads can't be allocated, the calling thread does all of the work.
+void segment_intersections_run(void *(*worker)(void*), SegmentIntersectionsJob *p_job, int32_t thread_count)
+{
+    int32_t extra_thread_count = thread_count - 1;
+    pthread_t *threads = (pthread_t*)malloc(sizeof(pthread_t) * max(extra_thread_count, 1));
+    int32_t started_count = 0;
+    for (int32_t i = 0; threads && i < extra_thread_count; i++)
+    {
+        if (pthread_create(&threads[started_count], NULL, worker, p_job) == 0)
+            started_count++;
+    }
+    worker(p_job);
+    for (int32_t i = 0; i < started_count; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+}
+
+bool SegmentIntersections_find(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    int32_t segment_count, int32_t square_width, int32_t thread_count,
+    SegmentIntersectionPair **out_pairs, int64_t *out_pair_count)
+{
+    *out_pairs = NULL;
+    *out_pair_count = 0;
+    if (segment_count <= 0)
+        return true;
+
+    SegmentIntersectionsJob job;
+    memset(&job, 0, sizeof(SegmentIntersectionsJob));
+    job.x1 = x1;
+    job.y1 = y1;
+    job.x2 = x2;
+    job.y2 = y2;
+    job.segment_count = segment_count;
+    job.square_width = square_width;
+    // The segments are traversed relative to the minimum of their coordinates, so they are never negative.
+    int32_t max_x = x1[0], max_y = y1[0];
+    job.origin_x = x1[0];
+    job.origin_y = y1[0];
+    for (int32_t i = 0; i < segment_count; i++)
+    {
+        job.origin_x = min(job.origin_x, min(x1[i], x2[i]));
+        job.origin_y = min(job.origin_y, min(y1[i], y2[i]));
+        max_x = max(max_x, max(x1[i], x2[i]));
+        max_y = max(max_y, max(y1[i], y2[i]));
+    }
+    if ((int64_t)max_x - job.origin_x > INT32_MAX || (int64_t)max_y - job.origin_y > INT32_MAX)
+        return false;
+    job.width = ((int64_t)max_x - job.origin_x) / square_width + 1;
+    job.height = ((int64_t)max_y - job.origin_y) / square_width + 1;
+
+    int32_t chunk_count = (segment_count + SEGMENT_INTERSECTIONS_CHUNK_SIZE - 1) / SEGMENT_INTERSECTIONS_CHUNK_SIZE;
+    thread_count = min(max(thread_count, 1), chunk_count);
+    job.worker_count = thread_count;
+    job.bucket_count = thread_count * SEGMENT_INTERSECTIONS_BUCKETS_PER_THREAD;
+    job.workers = (SegmentIntersectionsWorker*)calloc(thread_count, sizeof(SegmentIntersectionsWorker));
+    bool success = job.workers != NULL;
+    for (int32_t i = 0; success && i < thread_count; i++)
+    {
+        job.workers[i].bucket_entries =
+            (SegmentIntersectionsEntry**)calloc(job.bucket_count, sizeof(SegmentIntersectionsEntry*));
+        job.workers[i].bucket_counts = (int64_t*)calloc(job.bucket_count, sizeof(int64_t));
+        job.workers[i].bucket_capacities = (int64_t*)calloc(job.bucket_count, sizeof(int64_t));
+        success = job.workers[i].bucket_entries && job.workers[i].bucket_counts && job.workers[i].bucket_capacities;
+    }
+
+    if (success)
+    {
+        // First every thread bins the cells of its segments, then every bucket is searched for pairs.
+        pthread_mutex_init(&job.mutex, NULL);
+        segment_intersections_run(segment_intersections_bin_worker, &job, thread_count);
+        for (int32_t i = 0; i < thread_count; i++)
+            success &= !job.workers[i].failed;
+        job.next_worker = 0;
+        if (success)
+            segment_intersections_run(segment_intersections_pair_worker, &job, thread_count);
+        pthread_mutex_destroy(&job.mutex);
+    }
+
+    // A pair which shares several cells is found once per cell, so the pairs are sorted and made unique.
+    int64_t pair_count = 0;
+    for (int32_t i = 0; success && i < thread_count; i++)
+    {
+        success &= !job.workers[i].failed;
+        pair_count += job.workers[i].pair_count;
+    }
+    SegmentIntersectionPair *pairs = NULL;
+    if (success)
+    {
+        pairs = (SegmentIntersectionPair*)malloc(sizeof(SegmentIntersectionPair) * max(pair_count, (int64_t)1));
+        success = pairs != NULL;
+    }
+    if (success)
+    {
+        pair_count = 0;
+        for (int32_t i = 0; i < thread_count; i++)
+        {
+            if (job.workers[i].pair_count == 0)
+                continue;
+            memcpy(pairs + pair_count, job.workers[i].pairs,
+                sizeof(SegmentIntersectionPair) * job.workers[i].pair_count);
+            pair_count += job.workers[i].pair_count;
+        }
+        qsort(pairs, (size_t)pair_count, sizeof(SegmentIntersectionPair), segment_intersections_compare_pairs);
+        int64_t unique_count = 0;
+        for (int64_t i = 0; i < pair_count; i++)
+        {
+            if (unique_count == 0 || segment_intersections_compare_pairs(&pairs[unique_count - 1], &pairs[i]) != 0)
+                pairs[unique_count++] = pairs[i];
+        }
+        *out_pairs = pairs;
+        *out_pair_count = unique_count;
+    }
+
+    for (int32_t i = 0; job.workers && i < thread_count; i++)
+    {
+        for (int32_t bucket = 0; job.workers[i].bucket_entries && bucket < job.bucket_count; bucket++)
+            free(job.workers[i].bucket_entries[bucket]);
+        free(job.workers[i].bucket_entries);
+        free(job.workers[i].bucket_counts);
+        free(job.workers[i].bucket_capacities);
+        free(job.workers[i].scratch);
+        free(job.workers[i].pairs);
+    }
+    free(job.workers);
+    return success;
+}
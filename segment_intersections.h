@@ -0,0 +1,55 @@
+/// segment_intersections.h
+/// Provides functions for finding all pairs of intersecting line segments using multiple threads.
+
+#ifndef SEGMENT_INTERSECTIONS_H
+#define SEGMENT_INTERSECTIONS_H
+
+#include "line_traverser.h"
+
+/// The number of segments given to a thread at a time.
+#define SEGMENT_INTERSECTIONS_CHUNK_SIZE 256
+
+/// The number of hash buckets of grid cells per thread. Every bucket is searched for pairs by one thread.
+#define SEGMENT_INTERSECTIONS_BUCKETS_PER_THREAD 4
+
+/// A pair of intersecting segments, where first_id < second_id.
+typedef struct
+{
+    int32_t first_id;
+    int32_t second_id;
+} SegmentIntersectionPair;
+
+/// Tests if two line segments intersect, using exact integer orientation tests.
+/// @param x1 is the 1st x point of the 1st segment.
+/// @param y1 is the 1st y point of the 1st segment.
+/// @param x2 is the 2nd x point of the 1st segment.
+/// @param y2 is the 2nd y point of the 1st segment.
+/// @param x3 is the 1st x point of the 2nd segment.
+/// @param y3 is the 1st y point of the 2nd segment.
+/// @param x4 is the 2nd x point of the 2nd segment.
+/// @param y4 is the 2nd y point of the 2nd segment.
+/// @returns true if the segments share any point, including when they only touch or overlap along a line.
+bool SegmentIntersections_intersect(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+    int32_t x3, int32_t y3, int32_t x4, int32_t y4);
+
+/// Finds all pairs of intersecting line segments.
+/// Every segment is traversed over a grid, and pairs of segments which share a grid cell are tested exactly
+/// with SegmentIntersections_intersect().
+/// @param x1 is an array of the 1st x points of the segments.
+/// @param y1 is an array of the 1st y points of the segments.
+/// @param x2 is an array of the 2nd x points of the segments.
+/// @param y2 is an array of the 2nd y points of the segments.
+/// @param segment_count is the number of segments.
+/// @param square_width is the width of a cell of the grid, in the coordinates of the segments. Cells which are
+/// several times the typical segment length keep the number of cells per segment and pairs per cell low.
+/// @param thread_count is the number of threads to use, including the calling thread.
+/// @param out_pairs is a pointer to write an array of the intersecting pairs to, sorted by first_id and then
+/// second_id. The array must be freed with free().
+/// @param out_pair_count is a pointer to write the number of intersecting pairs to.
+/// @returns true if the pairs were found, false if memory could not be allocated, or if the bounding box of
+/// the segments is 2^31 or more wide or high.
+bool SegmentIntersections_find(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    int32_t segment_count, int32_t square_width, int32_t thread_count,
+    SegmentIntersectionPair **out_pairs, int64_t *out_pair_count);
+
+#endif // SEGMENT_INTERSECTIONS_H
@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "draw_line.h"
+#include "draw_line_parallel.h"
+
+bool verify_drawlines_parallel(int32_t line_count, int32_t pixel_width, int width, int height, int32_t thread_count,
+    bool snap_to_tiles, bool include_endpoints, bool past_top_left = false)
+{
+    std::vector<int32_t> x1(line_count), y1(line_count), x2(line_count), y2(line_count);
+    std::vector<uint32_t> colors(line_count);
+    int64_t tile_width = (int64_t)pixel_width * DRAW_LINE_PARALLEL_TILE_SIZE;
+    // Lines may go past the right and bottom of the image, as far as the coordinates fit.
+    int32_t range_x = (int32_t)std::min((int64_t)(width + 40) * pixel_width, (int64_t)RAND_MAX);
+    int32_t range_y = (int32_t)std::min((int64_t)(height + 40) * pixel_width, (int64_t)RAND_MAX);
+    for (int32_t i = 0; i < line_count; i++)
+    {
+        x1[i] = rand() % range_x;
+        y1[i] = rand() % range_y;
+        x2[i] = rand() % range_x;
+        y2[i] = rand() % range_y;
+        if (snap_to_tiles)
+        {
+            x1[i] -= x1[i] % tile_width;
+            y2[i] -= y2[i] % tile_width;
+        }
+        if (past_top_left)
+        {
+            // Lines with negative coordinates, which may start or end off the left and top of the image.
+            x1[i] -= 40 * pixel_width;
+            y1[i] -= 40 * pixel_width;
+            x2[i] -= (i % 2) ? 40 * pixel_width : 0;
+        }
+        colors[i] = (uint32_t)i + 1;
+    }
+
+    std::vector<uint32_t> correct_pixels(width * height);
+    std::vector<uint32_t> pixels(width * height);
+    for (int32_t i = 0; i < line_count; i++)
+    {
+        if (include_endpoints)
+            drawline_include_endpoints(x1[i], y1[i], x2[i], y2[i], pixel_width, colors[i],
+                correct_pixels.data(), width, height);
+        else
+            drawline_exclude_endpoints(x1[i], y1[i], x2[i], y2[i], pixel_width, colors[i],
+                correct_pixels.data(), width, height);
+    }
+    bool drawn;
+    if (include_endpoints)
+        drawn = drawlines_parallel_include_endpoints(x1.data(), y1.data(), x2.data(), y2.data(), colors.data(),
+            line_count, pixel_width, pixels.data(), width, height, thread_count);
+    else
+        drawn = drawlines_parallel_exclude_endpoints(x1.data(), y1.data(), x2.data(), y2.data(), colors.data(),
+            line_count, pixel_width, pixels.data(), width, height, thread_count);
+    return drawn && pixels == correct_pixels;
+}
+
+TEST(draw_line_parallel_tests, DrawLine)
+{
+    for (int32_t thread_count = 1; thread_count <= 4; thread_count++)
+    {
+        for (int32_t pixel_width = 1; pixel_width <= 16; pixel_width *= 4)
+        {
+            EXPECT_TRUE(verify_drawlines_parallel(1, pixel_width, 64, 64, thread_count, false, true));
+            EXPECT_TRUE(verify_drawlines_parallel(500, pixel_width, 300, 200, thread_count, false, true));
+            EXPECT_TRUE(verify_drawlines_parallel(500, pixel_width, 300, 200, thread_count, false, false));
+            EXPECT_TRUE(verify_drawlines_parallel(500, pixel_width, 257, 129, thread_count, true, true));
+            EXPECT_TRUE(verify_drawlines_parallel(500, pixel_width, 257, 129, thread_count, true, false));
+        }
+    }
+    for (int32_t pixel_width = 1; pixel_width <= 16; pixel_width *= 4)
+    {
+        EXPECT_TRUE(verify_drawlines_parallel(500, pixel_width, 300, 200, 3, false, true, true));
+        EXPECT_TRUE(verify_drawlines_parallel(500, pixel_width, 257, 129, 3, true, false, true));
+    }
+    // Tiles of pixels this wide don't fit in a traverser.
+    EXPECT_TRUE(verify_drawlines_parallel(200, 1 << 25, 70, 90, 3, false, true));
+    EXPECT_TRUE(verify_drawlines_parallel(200, 1 << 25, 70, 90, 3, false, false));
+    EXPECT_TRUE(verify_drawlines_parallel(20, 3, 1, 1, 2, false, true));
+    EXPECT_TRUE(verify_drawlines_parallel(2000, 3, 100, 1000, 3, false, false));
+}
@@ -4,6 +4,7 @@
 #include <vector>
 #include <functional>
 #include <cmath>
+#include <algorithm>
 #include "gtest/gtest.h"
 #include "line_bounder.h"
 
@@ -221,6 +222,477 @@ TEST(auto_tests, LineBounder)
     }
 }
 
+void bounder_collect_parametric_callback(int32_t x, int32_t y, int64_t t_enter, int64_t t_exit,
+    int64_t t_denominator, void *user_data)
+{
+    std::vector<std::pair<std::pair<int, int>, double>> *p_cells =
+        (std::vector<std::pair<std::pair<int, int>, double>>*)user_data;
+    p_cells->push_back(std::make_pair(std::make_pair(x, y), (double)t_enter / t_denominator));
+}
+
+// Returns false only if the traverser is wrong, skipping lines where rounding makes the double reference unreliable.
+bool test_line_bound_traverser_verify(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width,
+    int32_t x_min, int32_t x_max, int32_t y_min, int32_t y_max)
+{
+    double t_near, t_far;
+    bool correct_hit = test_line_bounder_correct(x1, y1, x2, y2, x_min, x_max, y_min, y_max, &t_near, &t_far);
+    std::vector<std::pair<std::pair<int, int>, double>> all_cells;
+    LineTraverser_traverse_parametric_include_endpoints(x1, y1, x2, y2, square_width,
+        bounder_collect_parametric_callback, &all_cells);
+    const double epsilon = 0.0000001;
+    if (correct_hit && t_far - t_near < epsilon)
+        return true;
+    for (size_t i = 1; i < all_cells.size(); i++)
+    {
+        if (fabs(all_cells[i].second - t_near) < epsilon || fabs(all_cells[i].second - t_far) < epsilon)
+            return true;
+    }
+
+    std::vector<std::pair<int, int>> correct_cells;
+    if (correct_hit)
+    {
+        for (size_t i = 0; i < all_cells.size(); i++)
+        {
+            bool entered_before_far = i == 0 || all_cells[i].second < t_far;
+            bool exited_after_near = i + 1 == all_cells.size() || all_cells[i + 1].second > t_near;
+            if (entered_before_far && exited_after_near)
+                correct_cells.push_back(all_cells[i].first);
+        }
+    }
+
+    LineTraverser traverser;
+    std::vector<std::pair<int, int>> cells;
+    if (line_bound_traverser_inside_rect(&traverser, x1, y1, x2, y2, square_width, x_min, y_min, x_max, y_max))
+    {
+        while (cells.size() <= all_cells.size())
+        {
+            int32_t x, y;
+            LineTraverser_get_point(&traverser, &x, &y);
+            cells.push_back(std::pair<int, int>(x, y));
+            if (LineTraverser_is_end(&traverser))
+                break;
+            LineTraverser_next(&traverser);
+        }
+    }
+    return cells == correct_cells;
+}
+
+TEST(auto_tests, LineBoundTraverser)
+{
+    for (int i = 0; i < 200000; i++)
+    {
+        int32_t x1 = rand() % 1024;
+        int32_t y1 = rand() % 1024;
+        int32_t x2 = rand() % 1024;
+        int32_t y2 = rand() % 1024;
+        if (x1 == x2 && y1 == y2)
+            continue;
+        int32_t square_width = 1 + rand() % 32;
+        int32_t x_min = rand() % 1022;
+        int32_t y_min = rand() % 1022;
+        int32_t x_max = x_min + (rand() % (1024 - x_min)) + 1;
+        int32_t y_max = y_min + (rand() % (1024 - y_min)) + 1;
+        EXPECT_TRUE(test_line_bound_traverser_verify(x1, y1, x2, y2, square_width, x_min, x_max, y_min, y_max));
+    }
+}
+
+TEST(auto_tests, LineBoundBatch)
+{
+    for (int batch = 0; batch < 2000; batch++)
+    {
+        // Small coordinate ranges make vertical, horizontal and zero length lines common.
+        int32_t range = (batch % 3 == 0) ? 8 : ((batch % 3 == 1) ? 1024 : (1 << 24));
+        int32_t count = rand() % 100;
+        std::vector<int32_t> x1(count), y1(count), x2(count), y2(count);
+        for (int32_t i = 0; i < count; i++)
+        {
+            x1[i] = rand() % (2 * range) - range;
+            y1[i] = rand() % (2 * range) - range;
+            x2[i] = rand() % (2 * range) - range;
+            y2[i] = rand() % (2 * range) - range;
+        }
+        int32_t x_min = rand() % range - range / 2;
+        int32_t y_min = rand() % range - range / 2;
+        int32_t x_max = x_min + rand() % range;
+        int32_t y_max = y_min + rand() % range;
+
+        std::vector<uint32_t> hit_masks((count + 31) / 32 + 1, 0xFFFFFFFF);
+        std::vector<int32_t> out_x1(count), out_y1(count), out_x2(count), out_y2(count);
+        line_bound_inside_rect_batch(x1.data(), y1.data(), x2.data(), y2.data(), count, x_min, y_min, x_max, y_max,
+            hit_masks.data(), out_x1.data(), out_y1.data(), out_x2.data(), out_y2.data());
+        for (int32_t i = 0; i < count; i++)
+        {
+            int64_t bounded_x1, bounded_y1, bounded_x2, bounded_y2;
+            bool hit = line_bound_inside_rect64(x1[i], y1[i], x2[i], y2[i], x_min, y_min, x_max, y_max,
+                &bounded_x1, &bounded_y1, &bounded_x2, &bounded_y2);
+            if (range <= 1024)
+            {
+                int32_t small_x1, small_y1, small_x2, small_y2;
+                EXPECT_EQ(hit, line_bound_inside_rect(x1[i], y1[i], x2[i], y2[i], x_min, y_min, x_max, y_max,
+                    &small_x1, &small_y1, &small_x2, &small_y2));
+            }
+            EXPECT_EQ(hit, ((hit_masks[i / 32] >> (i % 32)) & 1) != 0);
+            if (hit)
+            {
+                EXPECT_EQ(bounded_x1, out_x1[i]);
+                EXPECT_EQ(bounded_y1, out_y1[i]);
+                EXPECT_EQ(bounded_x2, out_x2[i]);
+                EXPECT_EQ(bounded_y2, out_y2[i]);
+            }
+        }
+        if (count % 32 != 0)
+        {
+            EXPECT_EQ(0u, hit_masks[count / 32] >> (count % 32));
+        }
+        EXPECT_EQ(0xFFFFFFFFu, hit_masks[(count + 31) / 32]);
+    }
+}
+
+TEST(auto_tests, LineBoundBatchLarge)
+{
+    // Coordinates beyond 2^25 aren't exact in the double precision SIMD lanes, so they must give the same
+    // result as line_bound_inside_rect64() whatever the build flags.
+    for (int batch = 0; batch < 2000; batch++)
+    {
+        int32_t count = rand() % 100;
+        std::vector<int32_t> x1(count), y1(count), x2(count), y2(count);
+        for (int32_t i = 0; i < count; i++)
+        {
+            // Mix small and large lines in the same batch, so only some groups of lanes are out of range.
+            int64_t range = (rand() % 4 == 0) ? 1000 : 1000000000;
+            x1[i] = (int32_t)(rand() % (2 * range) - range);
+            y1[i] = (int32_t)(rand() % (2 * range) - range);
+            x2[i] = (int32_t)(rand() % (2 * range) - range);
+            y2[i] = (int32_t)(rand() % (2 * range) - range);
+        }
+        int32_t range = (batch % 2 == 0) ? 1000 : 1000000000;
+        int32_t x_min = rand() % range - range / 2;
+        int32_t y_min = rand() % range - range / 2;
+        int32_t x_max = x_min + rand() % range;
+        int32_t y_max = y_min + rand() % range;
+        if (batch == 0)
+        {
+            x_min = INT32_MIN;
+            y_min = INT32_MIN;
+            x_max = INT32_MAX;
+            y_max = INT32_MAX;
+        }
+
+        std::vector<uint32_t> hit_masks((count + 31) / 32, 0);
+        std::vector<int32_t> out_x1(count), out_y1(count), out_x2(count), out_y2(count);
+        line_bound_inside_rect_batch(x1.data(), y1.data(), x2.data(), y2.data(), count, x_min, y_min, x_max, y_max,
+            hit_masks.data(), out_x1.data(), out_y1.data(), out_x2.data(), out_y2.data());
+        for (int32_t i = 0; i < count; i++)
+        {
+            int64_t bounded_x1, bounded_y1, bounded_x2, bounded_y2;
+            bool hit = line_bound_inside_rect64(x1[i], y1[i], x2[i], y2[i], x_min, y_min, x_max, y_max,
+                &bounded_x1, &bounded_y1, &bounded_x2, &bounded_y2);
+            EXPECT_EQ(hit, ((hit_masks[i / 32] >> (i % 32)) & 1) != 0);
+            if (hit)
+            {
+                EXPECT_EQ(bounded_x1, out_x1[i]);
+                EXPECT_EQ(bounded_y1, out_y1[i]);
+                EXPECT_EQ(bounded_x2, out_x2[i]);
+                EXPECT_EQ(bounded_y2, out_y2[i]);
+            }
+        }
+    }
+
+    // The clipped end of a line past a region edge far beyond 2^25 lands exactly on the edge.
+    int32_t x1[8], y1[8], x2[8], y2[8], out_x1[8], out_y1[8], out_x2[8], out_y2[8];
+    uint32_t hit_mask = 0;
+    for (int32_t i = 0; i < 8; i++)
+    {
+        x1[i] = -7 - i;
+        y1[i] = -3;
+        x2[i] = 2000000000 - 13 * i;
+        y2[i] = 700000003 + i;
+    }
+    line_bound_inside_rect_batch(x1, y1, x2, y2, 8, 0, 0, 2000000000, 350000000, &hit_mask,
+        out_x1, out_y1, out_x2, out_y2);
+    for (int32_t i = 0; i < 8; i++)
+    {
+        int64_t bounded_x1, bounded_y1, bounded_x2, bounded_y2;
+        EXPECT_TRUE(line_bound_inside_rect64(x1[i], y1[i], x2[i], y2[i], 0, 0, 2000000000, 350000000,
+            &bounded_x1, &bounded_y1, &bounded_x2, &bounded_y2));
+        EXPECT_EQ(1u, (hit_mask >> i) & 1);
+        EXPECT_EQ(bounded_x2, out_x2[i]);
+        EXPECT_EQ(bounded_y2, out_y2[i]);
+    }
+}
+
+void bounder_collect_cell_callback(int32_t x, int32_t y, void *user_data)
+{
+    ((std::vector<std::pair<int, int>>*)user_data)->push_back(std::pair<int, int>(x, y));
+}
+
+TEST(auto_tests, LineBoundRects)
+{
+    for (int i = 0; i < 20000; i++)
+    {
+        int32_t x1 = rand() % 1024;
+        int32_t y1 = rand() % 1024;
+        int32_t x2 = (i % 8 == 0) ? x1 : rand() % 1024;
+        int32_t y2 = (i % 8 == 1) ? y1 : rand() % 1024;
+        if (x1 == x2 && y1 == y2)
+            continue;
+        int32_t square_width = 1 + rand() % 32;
+        int32_t rect_count = rand() % 12;
+        std::vector<int32_t> x_min(rect_count), y_min(rect_count), x_max(rect_count), y_max(rect_count);
+        for (int32_t j = 0; j < rect_count; j++)
+        {
+            x_min[j] = rand() % 1022;
+            y_min[j] = rand() % 1022;
+            x_max[j] = x_min[j] + (rand() % (1024 - x_min[j]) / 4) + 1;
+            y_max[j] = y_min[j] + (rand() % (1024 - y_min[j]) / 4) + 1;
+        }
+
+        // The squares inside any region are those of the single region traversers, in order along the line.
+        std::vector<std::pair<int, int>> all_cells;
+        LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width,
+            bounder_collect_cell_callback, &all_cells);
+        std::vector<bool> inside(all_cells.size(), false);
+        for (int32_t j = 0; j < rect_count; j++)
+        {
+            LineTraverser traverser;
+            if (!line_bound_traverser_inside_rect(&traverser, x1, y1, x2, y2, square_width,
+                x_min[j], y_min[j], x_max[j], y_max[j]))
+                continue;
+            size_t k = 0;
+            while (true)
+            {
+                int32_t x, y;
+                LineTraverser_get_point(&traverser, &x, &y);
+                while (k < all_cells.size() && all_cells[k] != std::pair<int, int>(x, y))
+                    k++;
+                ASSERT_LT(k, all_cells.size());
+                inside[k] = true;
+                if (LineTraverser_is_end(&traverser))
+                    break;
+                LineTraverser_next(&traverser);
+            }
+        }
+        std::vector<std::pair<int, int>> correct_cells;
+        for (size_t k = 0; k < all_cells.size(); k++)
+        {
+            if (inside[k])
+                correct_cells.push_back(all_cells[k]);
+        }
+
+        std::vector<std::pair<int, int>> cells;
+        EXPECT_TRUE(line_bound_traverse_inside_rects(x1, y1, x2, y2, square_width, x_min.data(), y_min.data(),
+            x_max.data(), y_max.data(), rect_count, bounder_collect_cell_callback, &cells));
+        EXPECT_TRUE(cells == correct_cells);
+
+        std::vector<int64_t> begin_numerators(rect_count), begin_denominators(rect_count);
+        std::vector<int64_t> end_numerators(rect_count), end_denominators(rect_count);
+        int32_t range_count = line_bound_inside_rects(x1, y1, x2, y2, x_min.data(), y_min.data(),
+            x_max.data(), y_max.data(), rect_count, begin_numerators.data(), begin_denominators.data(),
+            end_numerators.data(), end_denominators.data());
+        for (int32_t j = 0; j < range_count; j++)
+        {
+            EXPECT_GT(begin_denominators[j], 0);
+            EXPECT_GT(end_denominators[j], 0);
+            EXPECT_LT(begin_numerators[j] * end_denominators[j], end_numerators[j] * begin_denominators[j]);
+            if (j > 0)
+            {
+                EXPECT_LT(end_numerators[j - 1] * begin_denominators[j], begin_numerators[j] * end_denominators[j - 1]);
+            }
+        }
+    }
+}
+
+std::vector<std::pair<int, int>> bounder_traverser_cells(LineTraverser *p_traverser)
+{
+    std::vector<std::pair<int, int>> cells;
+    while (true)
+    {
+        int32_t x, y;
+        LineTraverser_get_point(p_traverser, &x, &y);
+        cells.push_back(std::pair<int, int>(x, y));
+        if (LineTraverser_is_end(p_traverser))
+            break;
+        LineTraverser_next(p_traverser);
+    }
+    return cells;
+}
+
+TEST(auto_tests, LineBoundPolygonRect)
+{
+    for (int i = 0; i < 50000; i++)
+    {
+        int32_t x1 = rand() % 1024;
+        int32_t y1 = rand() % 1024;
+        int32_t x2 = rand() % 1024;
+        int32_t y2 = rand() % 1024;
+        if (x1 == x2 && y1 == y2)
+            continue;
+        int32_t square_width = 1 + rand() % 32;
+        int32_t x_min = rand() % 1022;
+        int32_t y_min = rand() % 1022;
+        int32_t x_max = x_min + (rand() % (1024 - x_min)) + 1;
+        int32_t y_max = y_min + (rand() % (1024 - y_min)) + 1;
+        int32_t xs[4] = { x_min, x_max, x_max, x_min };
+        int32_t ys[4] = { y_min, y_min, y_max, y_max };
+        if (i % 2)
+        {
+            std::swap(xs[1], xs[3]);
+            std::swap(ys[1], ys[3]);
+        }
+        LineBoundPolygon polygon;
+        ASSERT_TRUE(LineBoundPolygon_init(&polygon, xs, ys, 4));
+
+        LineTraverser rect_traverser, polygon_traverser;
+        bool rect_hit = line_bound_traverser_inside_rect(&rect_traverser, x1, y1, x2, y2, square_width,
+            x_min, y_min, x_max, y_max);
+        bool polygon_hit = line_bound_traverser_inside_polygon(&polygon_traverser, &polygon, x1, y1, x2, y2,
+            square_width);
+        EXPECT_EQ(rect_hit, polygon_hit);
+        if (rect_hit && polygon_hit)
+        {
+            EXPECT_TRUE(bounder_traverser_cells(&rect_traverser) == bounder_traverser_cells(&polygon_traverser));
+        }
+        LineBoundPolygon_destroy(&polygon);
+    }
+}
+
+TEST(auto_tests, LineBoundPolygon)
+{
+    int32_t concave_x[5] = { 0, 10, 5, 10, 0 };
+    int32_t concave_y[5] = { 0, 0, 5, 10, 10 };
+    int32_t flat_x[3] = { 0, 5, 10 };
+    int32_t flat_y[3] = { 0, 5, 10 };
+    LineBoundPolygon polygon;
+    EXPECT_FALSE(LineBoundPolygon_init(&polygon, concave_x, concave_y, 5));
+    EXPECT_FALSE(LineBoundPolygon_init(&polygon, flat_x, flat_y, 3));
+    EXPECT_FALSE(LineBoundPolygon_init(&polygon, flat_x, flat_y, 2));
+
+    // A pentagram turns the same way at every corner, but goes around twice.
+    int32_t pentagon_x[5] = { 100, 31, -81, -81, 31 };
+    int32_t pentagon_y[5] = { 0, 95, 59, -59, -95 };
+    int32_t pentagram_x[5], pentagram_y[5];
+    for (int32_t j = 0; j < 5; j++)
+    {
+        pentagram_x[j] = pentagon_x[(2 * j) % 5];
+        pentagram_y[j] = pentagon_y[(2 * j) % 5];
+    }
+    ASSERT_TRUE(LineBoundPolygon_init(&polygon, pentagon_x, pentagon_y, 5));
+    LineBoundPolygon_destroy(&polygon);
+    EXPECT_FALSE(LineBoundPolygon_init(&polygon, pentagram_x, pentagram_y, 5));
+    // Collinear and repeated vertices are allowed, but not an edge doubling back or a concave repeated corner.
+    int32_t collinear_x[6] = { 0, 5, 10, 10, 10, 0 };
+    int32_t collinear_y[6] = { 0, 0, 0, 0, 10, 10 };
+    ASSERT_TRUE(LineBoundPolygon_init(&polygon, collinear_x, collinear_y, 6));
+    LineBoundPolygon_destroy(&polygon);
+    int32_t spike_x[4] = { 0, 20, 10, 10 };
+    int32_t spike_y[4] = { 0, 0, 0, 10 };
+    EXPECT_FALSE(LineBoundPolygon_init(&polygon, spike_x, spike_y, 4));
+    int32_t repeated_concave_x[6] = { 0, 10, 5, 5, 10, 0 };
+    int32_t repeated_concave_y[6] = { 0, 0, 5, 5, 10, 10 };
+    EXPECT_FALSE(LineBoundPolygon_init(&polygon, repeated_concave_x, repeated_concave_y, 6));
+
+    for (int i = 0; i < 2000; i++)
+    {
+        // Vertices at increasing angles around an ellipse make a convex polygon, unless rounding breaks it.
+        int32_t vertex_count = 3 + rand() % 8;
+        std::vector<double> angles(vertex_count);
+        for (int32_t j = 0; j < vertex_count; j++)
+            angles[j] = (rand() % 100000) * 2 * M_PI / 100000;
+        std::sort(angles.begin(), angles.end());
+        if (i % 2)
+            std::reverse(angles.begin(), angles.end());
+        double center_x = 256 + rand() % 512, center_y = 256 + rand() % 512;
+        double radius_x = 16 + rand() % 240, radius_y = 16 + rand() % 240;
+        std::vector<int32_t> xs(vertex_count), ys(vertex_count);
+        for (int32_t j = 0; j < vertex_count; j++)
+        {
+            xs[j] = (int32_t)(center_x + radius_x * cos(angles[j]));
+            ys[j] = (int32_t)(center_y + radius_y * sin(angles[j]));
+        }
+        if (!LineBoundPolygon_init(&polygon, xs.data(), ys.data(), vertex_count))
+            continue;
+
+        const int32_t count = 200;
+        std::vector<int32_t> x1(count), y1(count), x2(count), y2(count);
+        for (int32_t j = 0; j < count; j++)
+        {
+            x1[j] = rand() % 1024;
+            y1[j] = rand() % 1024;
+            x2[j] = rand() % 1024;
+            y2[j] = rand() % 1024;
+        }
+        std::vector<uint32_t> hit_masks((count + 31) / 32);
+        std::vector<int64_t> begin_numerators(count), begin_denominators(count);
+        std::vector<int64_t> end_numerators(count), end_denominators(count);
+        line_bound_inside_polygon_batch(&polygon, x1.data(), y1.data(), x2.data(), y2.data(), count,
+            hit_masks.data(), begin_numerators.data(), begin_denominators.data(),
+            end_numerators.data(), end_denominators.data());
+        for (int32_t j = 0; j < count; j++)
+        {
+            int64_t begin_numerator, begin_denominator, end_numerator, end_denominator;
+            bool hit = line_bound_inside_polygon(&polygon, x1[j], y1[j], x2[j], y2[j],
+                &begin_numerator, &begin_denominator, &end_numerator, &end_denominator);
+            EXPECT_EQ(hit, ((hit_masks[j / 32] >> (j % 32)) & 1) != 0);
+            if (hit)
+            {
+                EXPECT_EQ(begin_numerator, begin_numerators[j]);
+                EXPECT_EQ(begin_denominator, begin_denominators[j]);
+                EXPECT_EQ(end_numerator, end_numerators[j]);
+                EXPECT_EQ(end_denominator, end_denominators[j]);
+            }
+
+            // Cyrus-Beck in doubles, skipping lines where rounding makes it unreliable.
+            double t_begin = 0, t_end = 1;
+            for (int32_t k = 0; k < vertex_count; k++)
+            {
+                int32_t next = (k + 1) % vertex_count;
+                double normal_x = polygon.normal_x[k], normal_y = polygon.normal_y[k];
+                double numerator = normal_x * (xs[k] - x1[j]) + normal_y * (ys[k] - y1[j]);
+                double denominator = normal_x * (x2[j] - x1[j]) + normal_y * (y2[j] - y1[j]);
+                EXPECT_EQ(polygon.normal_x[k] * (xs[next] - xs[k]) + polygon.normal_y[k] * (ys[next] - ys[k]), 0);
+                if (denominator == 0)
+                    t_end = (numerator > 0) ? -1 : t_end;
+                else if (denominator > 0)
+                    t_begin = max(t_begin, numerator / denominator);
+                else
+                    t_end = min(t_end, numerator / denominator);
+            }
+            const double epsilon = 0.000001;
+            if (fabs(t_end - t_begin) < epsilon)
+                continue;
+            EXPECT_EQ(t_begin < t_end, hit);
+            if (hit)
+            {
+                EXPECT_NEAR(t_begin, (double)begin_numerator / begin_denominator, epsilon);
+                EXPECT_NEAR(t_end, (double)end_numerator / end_denominator, epsilon);
+            }
+        }
+        LineBoundPolygon_destroy(&polygon);
+    }
+}
+
+TEST(auto_tests, LineBoundPolygonLimit)
+{
+    // The hypotenuse of this triangle and a line along the diagonal make the largest products within the limit.
+    const int32_t limit = (1 << 30) - 1;
+    int32_t xs[3] = { -limit, limit, -limit };
+    int32_t ys[3] = { -limit, -limit, limit };
+    LineBoundPolygon polygon;
+    ASSERT_TRUE(LineBoundPolygon_init(&polygon, xs, ys, 3));
+    int64_t begin_numerator, begin_denominator, end_numerator, end_denominator;
+    ASSERT_TRUE(line_bound_inside_polygon(&polygon, -limit, -limit, limit, limit,
+        &begin_numerator, &begin_denominator, &end_numerator, &end_denominator));
+    EXPECT_EQ(begin_numerator, 0);
+    EXPECT_EQ(end_numerator * 2, end_denominator);
+    ASSERT_TRUE(line_bound_inside_polygon(&polygon, limit, limit, -limit, -limit,
+        &begin_numerator, &begin_denominator, &end_numerator, &end_denominator));
+    EXPECT_EQ(begin_numerator * 2, begin_denominator);
+    EXPECT_EQ(end_numerator, end_denominator);
+    EXPECT_FALSE(line_bound_inside_polygon(&polygon, limit, -limit + 1, -limit + 1, limit,
+        &begin_numerator, &begin_denominator, &end_numerator, &end_denominator));
+    LineBoundPolygon_destroy(&polygon);
+}
+
 TEST(manual_tests, LineBounder)
 {
     int32_t x1, y1, x2, y2;
@@ -0,0 +1,153 @@
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "line_traverser64.h"
+#include "line_traverser.h"
+#include "line_bounder.h"
+
+void collect_cells64_callback(int64_t x, int64_t y, void *user_data)
+{
+    std::vector<std::pair<int64_t, int64_t>> *p_cells = (std::vector<std::pair<int64_t, int64_t>>*)user_data;
+    p_cells->push_back(std::pair<int64_t, int64_t>(x, y));
+}
+
+void collect_cells32_callback(int32_t x, int32_t y, void *user_data)
+{
+    std::vector<std::pair<int64_t, int64_t>> *p_cells = (std::vector<std::pair<int64_t, int64_t>>*)user_data;
+    p_cells->push_back(std::pair<int64_t, int64_t>(x, y));
+}
+
+// Traverses with LineTraverser64 directly, so lines that would be sent to the 32 bit path are still tested.
+std::vector<std::pair<int64_t, int64_t>> traverse64(int64_t x1, int64_t y1, int64_t x2, int64_t y2,
+    int64_t square_width)
+{
+    std::vector<std::pair<int64_t, int64_t>> cells;
+    LineTraverser64 traverser = LineTraverser64_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int64_t x, y;
+        LineTraverser64_get_point(&traverser, &x, &y);
+        cells.push_back(std::pair<int64_t, int64_t>(x, y));
+        if (LineTraverser64_is_end(&traverser))
+            break;
+        LineTraverser64_next(&traverser);
+    }
+    return cells;
+}
+
+bool verify_traverser64_matches32(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    std::vector<std::pair<int64_t, int64_t>> correct_cells;
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells32_callback, &correct_cells);
+    std::vector<std::pair<int64_t, int64_t>> dispatched_cells;
+    LineTraverser64_traverse_include_endpoints(x1, y1, x2, y2, square_width,
+        collect_cells64_callback, &dispatched_cells);
+
+    int64_t end_x1, end_y1, end_x2, end_y2;
+    LineTraverser64_get_endpoints(x1, y1, x2, y2, square_width, &end_x1, &end_y1, &end_x2, &end_y2);
+    return traverse64(x1, y1, x2, y2, square_width) == correct_cells && dispatched_cells == correct_cells &&
+        correct_cells.front() == std::pair<int64_t, int64_t>(end_x1, end_y1) &&
+        correct_cells.back() == std::pair<int64_t, int64_t>(end_x2, end_y2);
+}
+
+// Moving a line by a whole number of grid squares must move the traversed squares by the same amount.
+bool verify_traverser64_translation(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t square_width,
+    int64_t offset_x, int64_t offset_y, bool include_endpoints)
+{
+    std::vector<std::pair<int64_t, int64_t>> cells;
+    std::vector<std::pair<int64_t, int64_t>> moved_cells;
+    int64_t move_x = offset_x * square_width;
+    int64_t move_y = offset_y * square_width;
+    if (include_endpoints)
+    {
+        LineTraverser64_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells64_callback, &cells);
+        LineTraverser64_traverse_include_endpoints(x1 + move_x, y1 + move_y, x2 + move_x, y2 + move_y, square_width,
+            collect_cells64_callback, &moved_cells);
+    }
+    else
+    {
+        LineTraverser64_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, collect_cells64_callback, &cells);
+        LineTraverser64_traverse_exclude_endpoints(x1 + move_x, y1 + move_y, x2 + move_x, y2 + move_y, square_width,
+            collect_cells64_callback, &moved_cells);
+    }
+    if (cells.size() != moved_cells.size())
+        return false;
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        if (moved_cells[i].first != cells[i].first + offset_x || moved_cells[i].second != cells[i].second + offset_y)
+            return false;
+    }
+    return true;
+}
+
+TEST(line_traverser64_tests, LineTraverser64)
+{
+    EXPECT_TRUE(verify_traverser64_matches32(0, 0, 0, 0, 1));
+    EXPECT_TRUE(verify_traverser64_matches32(3, 5, 40, 17, 4));
+    EXPECT_TRUE(verify_traverser64_matches32(40, 16, 4, 4, 4));
+    EXPECT_TRUE(verify_traverser64_matches32(0, 0, 100000, 100000, 3));
+    for (int i = 0; i < 2000; i++)
+    {
+        int32_t x1 = rand() % 1000;
+        int32_t y1 = rand() % 1000;
+        int32_t x2 = rand() % 1000;
+        int32_t y2 = rand() % 1000;
+        int32_t square_width = 1 + rand() % 16;
+        EXPECT_TRUE(verify_traverser64_matches32(x1, y1, x2, y2, square_width));
+    }
+
+    // 2^20 grid squares per axis with 256 sub-squares, moved far past the range of 32 bit coordinates.
+    const int64_t square_width = 256;
+    const int64_t offset = (int64_t)1 << 40;
+    for (int i = 0; i < 200; i++)
+    {
+        int64_t x1 = ((int64_t)rand() << 8) % ((int64_t)square_width << 20);
+        int64_t y1 = ((int64_t)rand() << 8) % ((int64_t)square_width << 20);
+        int64_t x2 = x1 + rand() % 20000;
+        int64_t y2 = y1 + rand() % 20000;
+        EXPECT_TRUE(verify_traverser64_translation(x1, y1, x2, y2, square_width, offset, offset / 3, true));
+        EXPECT_TRUE(verify_traverser64_translation(x2, y2, x1, y1, square_width, offset / 5, offset, false));
+    }
+}
+
+TEST(line_traverser64_tests, LineBounder64)
+{
+    for (int i = 0; i < 100000; i++)
+    {
+        int32_t x1 = rand() % 1024;
+        int32_t y1 = rand() % 1024;
+        int32_t x2 = rand() % 1024;
+        int32_t y2 = rand() % 1024;
+        int32_t x_min = rand() % 1022;
+        int32_t y_min = rand() % 1022;
+        int32_t x_max = x_min + (rand() % (1024 - x_min)) + 1;
+        int32_t y_max = y_min + (rand() % (1024 - y_min)) + 1;
+
+        int32_t out32[4];
+        bool hit32 = line_bound_inside_rect(x1, y1, x2, y2, x_min, y_min, x_max, y_max,
+            &out32[0], &out32[1], &out32[2], &out32[3]);
+        int64_t out64[4];
+        bool hit64 = line_bound_inside_rect64(x1, y1, x2, y2, x_min, y_min, x_max, y_max,
+            &out64[0], &out64[1], &out64[2], &out64[3]);
+        EXPECT_EQ(hit32, hit64);
+        if (hit32 && hit64)
+        {
+            for (int j = 0; j < 4; j++)
+                EXPECT_EQ(out32[j], out64[j]);
+        }
+
+        // Far from the origin, the 32 bit products would overflow.
+        const int64_t offset = (int64_t)1 << 42;
+        int64_t moved64[4];
+        bool moved_hit64 = line_bound_inside_rect64(x1 + offset, y1 + offset, x2 + offset, y2 + offset,
+            x_min + offset, y_min + offset, x_max + offset, y_max + offset,
+            &moved64[0], &moved64[1], &moved64[2], &moved64[3]);
+        EXPECT_EQ(hit64, moved_hit64);
+        if (hit64 && moved_hit64)
+        {
+            for (int j = 0; j < 4; j++)
+                EXPECT_EQ(out64[j] + offset, moved64[j]);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "line_traverser_packet.h"
+
+bool verify_packet(const int32_t *x1, const int32_t *y1, const int32_t *x2, const int32_t *y2,
+    int32_t square_width, int32_t count)
+{
+    LineTraverser traversers[LINE_TRAVERSER_PACKET_WIDTH];
+    bool lane_done[LINE_TRAVERSER_PACKET_WIDTH];
+    for (int32_t i = 0; i < count; i++)
+    {
+        traversers[i] = LineTraverser_init(x1[i], y1[i], x2[i], y2[i], square_width);
+        lane_done[i] = false;
+    }
+
+    LineTraverserPacket packet;
+    uint32_t mask = LineTraverserPacket_init(&packet, x1, y1, x2, y2, square_width, count);
+    while (mask != 0)
+    {
+        int32_t xs[LINE_TRAVERSER_PACKET_WIDTH], ys[LINE_TRAVERSER_PACKET_WIDTH];
+        LineTraverserPacket_get_points(&packet, xs, ys);
+        for (int32_t i = 0; i < LINE_TRAVERSER_PACKET_WIDTH; i++)
+        {
+            bool active = (mask >> i) & 1;
+            if (i >= count)
+            {
+                if (active)
+                    return false;
+                continue;
+            }
+            if (active == lane_done[i])
+                return false;
+            if (!active)
+                continue;
+            const LineTraverser &t = traversers[i];
+            if (xs[i] != t.x || ys[i] != t.y || packet.clockwiseness[i] != t.clockwiseness)
+                return false;
+            if (LineTraverser_is_end(&traversers[i]))
+                lane_done[i] = true;
+            else
+                LineTraverser_next(&traversers[i]);
+        }
+        mask = LineTraverserPacket_next(&packet);
+    }
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (!lane_done[i])
+            return false;
+    }
+    return true;
+}
+
+TEST(packet_tests, LineTraverser)
+{
+    int32_t x1[LINE_TRAVERSER_PACKET_WIDTH], y1[LINE_TRAVERSER_PACKET_WIDTH];
+    int32_t x2[LINE_TRAVERSER_PACKET_WIDTH], y2[LINE_TRAVERSER_PACKET_WIDTH];
+    for (int i = 0; i < 2000; i++)
+    {
+        int32_t square_width = 1 << (rand() % 6);
+        int32_t count = 1 + rand() % LINE_TRAVERSER_PACKET_WIDTH;
+        for (int32_t lane = 0; lane < count; lane++)
+        {
+            x1[lane] = rand() % 1024;
+            y1[lane] = rand() % 1024;
+            x2[lane] = rand() % 1024;
+            y2[lane] = rand() % 1024;
+            // Some lines that start and end on grid boundaries, and some axis aligned ones.
+            if (rand() % 4 == 0)
+            {
+                x1[lane] -= x1[lane] % square_width;
+                y2[lane] -= y2[lane] % square_width;
+            }
+            if (rand() % 8 == 0)
+                x2[lane] = x1[lane];
+            if (rand() % 8 == 0)
+                y2[lane] = y1[lane];
+        }
+        EXPECT_TRUE(verify_packet(x1, y1, x2, y2, square_width, count));
+    }
+}
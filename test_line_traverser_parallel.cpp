@@ -0,0 +1,79 @@
+
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include "gtest/gtest.h"
+#include "line_traverser_parallel.h"
+
+typedef struct
+{
+    std::mutex mutex;
+    std::vector<std::pair<int, int>> cells;
+} ParallelCollectInfo;
+
+void parallel_collect_callback(int32_t x, int32_t y, void *user_data)
+{
+    ParallelCollectInfo *p_info = (ParallelCollectInfo*)user_data;
+    std::lock_guard<std::mutex> lock(p_info->mutex);
+    p_info->cells.push_back(std::pair<int, int>(x, y));
+}
+
+void serial_collect_callback(int32_t x, int32_t y, void *user_data)
+{
+    std::vector<std::pair<int, int>> *p_cells = (std::vector<std::pair<int, int>>*)user_data;
+    p_cells->push_back(std::pair<int, int>(x, y));
+}
+
+bool verify_parallel(int x1, int y1, int x2, int y2, int square_width, int thread_count, bool include_endpoints)
+{
+    std::vector<std::pair<int, int>> correct_cells;
+    ParallelCollectInfo ordered_info;
+    ParallelCollectInfo unordered_info;
+    if (include_endpoints)
+    {
+        LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, serial_collect_callback, &correct_cells);
+        EXPECT_TRUE(LineTraverser_traverse_parallel_include_endpoints(x1, y1, x2, y2, square_width,
+            parallel_collect_callback, &ordered_info, thread_count, true));
+        EXPECT_TRUE(LineTraverser_traverse_parallel_include_endpoints(x1, y1, x2, y2, square_width,
+            parallel_collect_callback, &unordered_info, thread_count, false));
+    }
+    else
+    {
+        LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, serial_collect_callback, &correct_cells);
+        EXPECT_TRUE(LineTraverser_traverse_parallel_exclude_endpoints(x1, y1, x2, y2, square_width,
+            parallel_collect_callback, &ordered_info, thread_count, true));
+        EXPECT_TRUE(LineTraverser_traverse_parallel_exclude_endpoints(x1, y1, x2, y2, square_width,
+            parallel_collect_callback, &unordered_info, thread_count, false));
+    }
+    if (ordered_info.cells != correct_cells)
+        return false;
+    // A line never visits the same grid square twice, so sorting both gives the same list.
+    std::sort(correct_cells.begin(), correct_cells.end());
+    std::sort(unordered_info.cells.begin(), unordered_info.cells.end());
+    return unordered_info.cells == correct_cells;
+}
+
+TEST(parallel_tests, LineTraverser)
+{
+    for (int thread_count = 1; thread_count <= 4; thread_count++)
+    {
+        EXPECT_TRUE(verify_parallel(0, 0, 0, 0, 1, thread_count, true));
+        EXPECT_TRUE(verify_parallel(0, 0, 0, 0, 1, thread_count, false));
+        EXPECT_TRUE(verify_parallel(3, 5, 40, 17, 4, thread_count, true));
+        EXPECT_TRUE(verify_parallel(3, 5, 40, 17, 4, thread_count, false));
+        EXPECT_TRUE(verify_parallel(0, 0, 100000, 0, 1, thread_count, true));
+        EXPECT_TRUE(verify_parallel(0, 7, 0, 100000, 4, thread_count, false));
+        for (int i = 0; i < 8; i++)
+        {
+            int x1 = rand() % 100000;
+            int y1 = rand() % 100000;
+            int x2 = rand() % 100000;
+            int y2 = rand() % 100000;
+            int square_width = 1 + rand() % 8;
+            EXPECT_TRUE(verify_parallel(x1, y1, x2, y2, square_width, thread_count, true));
+            EXPECT_TRUE(verify_parallel(x1, y1, x2, y2, square_width, thread_count, false));
+        }
+    }
+}
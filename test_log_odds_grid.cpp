@@ -0,0 +1,94 @@
+#include <stdlib.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "log_odds_grid.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+typedef struct
+{
+    int32_t width, height;
+    std::vector<bool> is_free;
+} CollectGridCellsInfo;
+
+void collect_grid_cells_callback(int32_t x, int32_t y, void *user_data)
+{
+    CollectGridCellsInfo *p_info = (CollectGridCellsInfo*)user_data;
+    if (x >= 0 && y >= 0 && x < p_info->width && y < p_info->height)
+        p_info->is_free[y * p_info->width + x] = true;
+}
+
+// Integrates a scan one beam at a time with LineTraverser_traverse_exclude_endpoints().
+void integrate_scan_serial(std::vector<int32_t> &log_odds, int32_t width, int32_t height,
+    int32_t origin_x, int32_t origin_y, const std::vector<int32_t> &hit_x, const std::vector<int32_t> &hit_y,
+    int32_t square_width, int32_t free_delta, int32_t occupied_delta, int32_t min_log_odds, int32_t max_log_odds)
+{
+    CollectGridCellsInfo free_info;
+    free_info.width = width;
+    free_info.height = height;
+    free_info.is_free.assign(width * height, false);
+    std::vector<bool> is_occupied(width * height, false);
+    for (size_t i = 0; i < hit_x.size(); i++)
+    {
+        LineTraverser_traverse_exclude_endpoints(origin_x, origin_y, hit_x[i], hit_y[i], square_width,
+            collect_grid_cells_callback, &free_info);
+        int32_t x1, y1, x2, y2;
+        LineTraverser_get_endpoints(origin_x, origin_y, hit_x[i], hit_y[i], square_width, &x1, &y1, &x2, &y2);
+        if (x2 >= 0 && y2 >= 0 && x2 < width && y2 < height)
+            is_occupied[y2 * width + x2] = true;
+    }
+    for (int32_t cell = 0; cell < width * height; cell++)
+    {
+        if (is_occupied[cell])
+            log_odds[cell] = max(min(log_odds[cell] + occupied_delta, max_log_odds), min_log_odds);
+        else if (free_info.is_free[cell])
+            log_odds[cell] = max(min(log_odds[cell] + free_delta, max_log_odds), min_log_odds);
+    }
+}
+
+TEST(log_odds_grid_tests, LogOddsGrid)
+{
+    const int32_t width = 200;
+    const int32_t height = 150;
+    const int32_t square_width = 16;
+    for (int32_t thread_count = 1; thread_count <= 4; thread_count++)
+    {
+        LogOddsGrid grid;
+        ASSERT_TRUE(LogOddsGrid_init(&grid, width, height, -4, 9, -100, 100));
+        std::vector<int32_t> correct_log_odds(width * height);
+        for (int scan = 0; scan < 10; scan++)
+        {
+            int32_t origin_x = rand() % (width * square_width);
+            int32_t origin_y = rand() % (height * square_width);
+            int32_t beam_count = (scan == 0) ? 1 : 1 + rand() % 3000;
+            std::vector<int32_t> hit_x(beam_count);
+            std::vector<int32_t> hit_y(beam_count);
+            for (int32_t i = 0; i < beam_count; i++)
+            {
+                // Some beams end outside of the grid.
+                hit_x[i] = rand() % ((width + 20) * square_width);
+                hit_y[i] = rand() % ((height + 20) * square_width);
+            }
+            EXPECT_TRUE(LogOddsGrid_integrate_scan(&grid, origin_x, origin_y, hit_x.data(), hit_y.data(),
+                beam_count, square_width, thread_count));
+            integrate_scan_serial(correct_log_odds, width, height, origin_x, origin_y, hit_x, hit_y,
+                square_width, -4, 9, -100, 100);
+        }
+        bool equal = true;
+        for (int32_t y = 0; y < height; y++)
+        {
+            for (int32_t x = 0; x < width; x++)
+            {
+                equal &= LogOddsGrid_get(&grid, x, y) == correct_log_odds[y * width + x];
+                equal &= grid.scan_flags[y * width + x] == 0;
+            }
+        }
+        EXPECT_TRUE(equal);
+        LogOddsGrid_destroy(&grid);
+    }
+}
@@ -0,0 +1,108 @@
+#include <stdlib.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "occupancy_pyramid.h"
+
+// Walks every grid square of the line with LineTraverser_next() until an occupied one is found.
+bool cast_fine(const std::vector<uint8_t> &occupancy, int32_t width, int32_t height,
+    int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width, int32_t *out_x, int32_t *out_y)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int32_t x, y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        if (x >= 0 && y >= 0 && x < width && y < height && occupancy[y * width + x])
+        {
+            *out_x = x;
+            *out_y = y;
+            return true;
+        }
+        if (LineTraverser_is_end(&traverser))
+            return false;
+        LineTraverser_next(&traverser);
+    }
+}
+
+bool verify_cast(const OccupancyPyramid *p_pyramid, const std::vector<uint8_t> &occupancy, int32_t width,
+    int32_t height, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t square_width)
+{
+    int32_t correct_x = -1, correct_y = -1, x = -1, y = -1;
+    bool correct_hit = cast_fine(occupancy, width, height, x1, y1, x2, y2, square_width, &correct_x, &correct_y);
+    bool hit = OccupancyPyramid_cast(p_pyramid, x1, y1, x2, y2, square_width, &x, &y);
+    return hit == correct_hit && x == correct_x && y == correct_y;
+}
+
+TEST(occupancy_pyramid_tests, OccupancyPyramid)
+{
+    int32_t sizes[][2] = { { 1, 1 }, { 64, 64 }, { 100, 37 }, { 256, 256 } };
+    int32_t densities[] = { 0, 1, 20, 500 };
+    for (int32_t *size : sizes)
+    {
+        int32_t width = size[0];
+        int32_t height = size[1];
+        for (int32_t density : densities)
+        {
+            std::vector<uint8_t> occupancy(width * height);
+            for (uint8_t &cell : occupancy)
+                cell = (rand() % 1000) < density;
+            OccupancyPyramid pyramid;
+            ASSERT_TRUE(OccupancyPyramid_init(&pyramid, occupancy.data(), width, height));
+            EXPECT_EQ(pyramid.level_widths[pyramid.level_count - 1], 1);
+            EXPECT_EQ(pyramid.level_heights[pyramid.level_count - 1], 1);
+            for (int i = 0; i < 500; i++)
+            {
+                int32_t square_width = 1 + rand() % 8;
+                // Lines may start and end outside of the grid, where every cell is empty.
+                int32_t x1 = rand() % ((width + 8) * square_width);
+                int32_t y1 = rand() % ((height + 8) * square_width);
+                int32_t x2 = rand() % ((width + 8) * square_width);
+                int32_t y2 = rand() % ((height + 8) * square_width);
+                EXPECT_TRUE(verify_cast(&pyramid, occupancy, width, height, x1, y1, x2, y2, square_width));
+                EXPECT_TRUE(verify_cast(&pyramid, occupancy, width, height, x1, y1, x1, y2, square_width));
+                EXPECT_TRUE(verify_cast(&pyramid, occupancy, width, height, x1, y1, x2, y1, square_width));
+            }
+
+            // Changing cells must keep the coarser levels consistent.
+            for (int i = 0; i < 50; i++)
+            {
+                int32_t x = rand() % width;
+                int32_t y = rand() % height;
+                bool occupied = !occupancy[y * width + x];
+                occupancy[y * width + x] = occupied;
+                OccupancyPyramid_set(&pyramid, x, y, occupied);
+                EXPECT_EQ(OccupancyPyramid_is_occupied(&pyramid, x, y), occupied);
+                int32_t square_width = 1 + rand() % 8;
+                int32_t x1 = rand() % (width * square_width);
+                int32_t y1 = rand() % (height * square_width);
+                EXPECT_TRUE(verify_cast(&pyramid, occupancy, width, height, x1, y1,
+                    x * square_width + square_width / 2, y * square_width + square_width / 2, square_width));
+            }
+            OccupancyPyramid_destroy(&pyramid);
+        }
+    }
+}
+
+TEST(occupancy_pyramid_tests, OccupancyPyramidMaxLevels)
+{
+    // A grid wide enough for every level is too big to allocate, so empty 1x1 levels stand in for it. The lines
+    // skip blocks of the top level, which are 2^31 cells wide.
+    uint8_t cell = 0;
+    OccupancyPyramid pyramid;
+    pyramid.level_count = OCCUPANCY_PYRAMID_MAX_LEVELS;
+    for (int32_t level = 0; level < OCCUPANCY_PYRAMID_MAX_LEVELS; level++)
+    {
+        pyramid.levels[level] = &cell;
+        pyramid.level_widths[level] = 1;
+        pyramid.level_heights[level] = 1;
+    }
+    int32_t x = -1, y = -1;
+    EXPECT_FALSE(OccupancyPyramid_cast(&pyramid, 0, 0, 1000, 3, 1, &x, &y));
+    EXPECT_FALSE(OccupancyPyramid_cast(&pyramid, 2000, 70, -1000, -3, 4, &x, &y));
+    EXPECT_FALSE(OccupancyPyramid_cast(&pyramid, -5, -5, -1000, -7, 1, &x, &y));
+    // The block left of the grid is skipped up to the occupied cell.
+    cell = 1;
+    EXPECT_TRUE(OccupancyPyramid_cast(&pyramid, -5, 0, 1000, 0, 1, &x, &y));
+    EXPECT_EQ(x, 0);
+    EXPECT_EQ(y, 0);
+}
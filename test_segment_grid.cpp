@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "segment_grid.h"
+#include "line_bounder.h"
+
+void collect_segment_ids_callback(int32_t segment_id, void *user_data)
+{
+    ((std::vector<int32_t>*)user_data)->push_back(segment_id);
+}
+
+typedef struct
+{
+    int32_t width;
+    int32_t segment_id;
+    std::vector<std::vector<int32_t>> *p_cells;
+} CollectSegmentCellsInfo;
+
+void collect_segment_cells_callback(int32_t x, int32_t y, void *user_data)
+{
+    CollectSegmentCellsInfo *p_info = (CollectSegmentCellsInfo*)user_data;
+    (*p_info->p_cells)[y * p_info->width + x].push_back(p_info->segment_id);
+}
+
+TEST(auto_tests, SegmentGrid)
+{
+    srand(0);
+    for (int test = 0; test < 40; test++)
+    {
+        int32_t segment_count = rand() % 500;
+        int32_t square_width = 1 + rand() % 64;
+        int32_t offset_x = rand() % 2000 - 1000, offset_y = rand() % 2000 - 1000;
+        std::vector<int32_t> x1(segment_count), y1(segment_count), x2(segment_count), y2(segment_count);
+        for (int32_t i = 0; i < segment_count; i++)
+        {
+            x1[i] = offset_x + rand() % 1024;
+            y1[i] = offset_y + rand() % 1024;
+            // Some short, vertical, horizontal and zero length segments.
+            x2[i] = (i % 5 == 0) ? x1[i] : ((i % 5 == 1) ? x1[i] + rand() % 32 : offset_x + rand() % 1024);
+            y2[i] = (i % 7 == 0) ? y1[i] : ((i % 7 == 1) ? y1[i] + rand() % 32 : offset_y + rand() % 1024);
+        }
+        SegmentGrid grid;
+        ASSERT_TRUE(SegmentGrid_init(&grid, x1.data(), y1.data(), x2.data(), y2.data(), segment_count, square_width));
+
+        std::vector<std::vector<int32_t>> cells((size_t)grid.width * grid.height);
+        for (int32_t i = 0; i < segment_count; i++)
+        {
+            CollectSegmentCellsInfo info = { grid.width, i, &cells };
+            LineTraverser_traverse_include_endpoints(x1[i] - grid.origin_x, y1[i] - grid.origin_y,
+                x2[i] - grid.origin_x, y2[i] - grid.origin_y, square_width, collect_segment_cells_callback, &info);
+        }
+        for (int32_t y = -1; y <= grid.height; y++)
+        {
+            for (int32_t x = -1; x <= grid.width; x++)
+            {
+                const int32_t *ids;
+                int64_t count = SegmentGrid_query_cell(&grid, x, y, &ids);
+                std::vector<int32_t> correct_ids;
+                if (x >= 0 && y >= 0 && x < grid.width && y < grid.height)
+                    correct_ids = cells[y * grid.width + x];
+                EXPECT_TRUE(std::vector<int32_t>(ids, ids + count) == correct_ids);
+            }
+        }
+
+        for (int query = 0; query < 100; query++)
+        {
+            int32_t x_min = offset_x + rand() % 1100 - 50;
+            int32_t y_min = offset_y + rand() % 1100 - 50;
+            int32_t x_max = x_min + rand() % 300;
+            int32_t y_max = y_min + rand() % 300;
+            std::vector<int32_t> correct_ids;
+            for (int32_t i = 0; i < segment_count; i++)
+            {
+                bool inside;
+                if (x1[i] == x2[i] && y1[i] == y2[i])
+                    inside = x1[i] >= x_min && x1[i] <= x_max && y1[i] >= y_min && y1[i] <= y_max;
+                else
+                {
+                    int32_t bounded_x1, bounded_y1, bounded_x2, bounded_y2;
+                    inside = line_bound_inside_rect(x1[i], y1[i], x2[i], y2[i], x_min, y_min, x_max, y_max,
+                        &bounded_x1, &bounded_y1, &bounded_x2, &bounded_y2);
+                }
+                if (inside)
+                    correct_ids.push_back(i);
+            }
+            std::vector<int32_t> ids;
+            EXPECT_TRUE(SegmentGrid_query_rect(&grid, x_min, y_min, x_max, y_max, collect_segment_ids_callback, &ids));
+            EXPECT_TRUE(ids == correct_ids);
+        }
+        SegmentGrid_destroy(&grid);
+    }
+}
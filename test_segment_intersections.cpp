@@ -0,0 +1,64 @@
+#include <stdlib.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "segment_intersections.h"
+
+TEST(auto_tests, SegmentIntersectionsIntersect)
+{
+    EXPECT_TRUE(SegmentIntersections_intersect(0, 0, 10, 10, 0, 10, 10, 0));
+    EXPECT_TRUE(SegmentIntersections_intersect(0, 0, 10, 10, 10, 10, 20, 0));
+    EXPECT_TRUE(SegmentIntersections_intersect(0, 0, 10, 10, 5, 5, 20, 20));
+    EXPECT_TRUE(SegmentIntersections_intersect(0, 0, 10, 0, 5, 0, 5, 0));
+    EXPECT_TRUE(SegmentIntersections_intersect(0, 0, 10, 0, 5, -5, 5, 0));
+    EXPECT_FALSE(SegmentIntersections_intersect(0, 0, 10, 10, 11, 11, 20, 20));
+    EXPECT_FALSE(SegmentIntersections_intersect(0, 0, 10, 10, 0, 1, 10, 11));
+    EXPECT_FALSE(SegmentIntersections_intersect(0, 0, 10, 10, 6, 5, 20, 0));
+    EXPECT_FALSE(SegmentIntersections_intersect(0, 0, 0, 0, 1, 1, 1, 1));
+    EXPECT_TRUE(SegmentIntersections_intersect(INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX,
+        INT32_MIN, INT32_MAX, INT32_MAX, INT32_MIN));
+    EXPECT_FALSE(SegmentIntersections_intersect(INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX,
+        INT32_MIN + 1, INT32_MIN, INT32_MAX, INT32_MAX - 1));
+}
+
+TEST(auto_tests, SegmentIntersections)
+{
+    srand(0);
+    for (int test = 0; test < 60; test++)
+    {
+        int32_t segment_count = rand() % 600;
+        int32_t square_width = 1 + rand() % 16;
+        // Coordinates on a lattice of the grid make segments often cross exactly at cell corners.
+        int32_t lattice = (test % 2) ? square_width : 1;
+        int32_t range = 16 + rand() % 256;
+        int32_t offset = rand() % 200 - 100;
+        std::vector<int32_t> x1(segment_count), y1(segment_count), x2(segment_count), y2(segment_count);
+        for (int32_t i = 0; i < segment_count; i++)
+        {
+            x1[i] = offset + (rand() % range) * lattice;
+            y1[i] = offset + (rand() % range) * lattice;
+            x2[i] = (i % 9 == 0) ? x1[i] : x1[i] + (rand() % 17 - 8) * lattice;
+            y2[i] = (i % 11 == 0) ? y1[i] : y1[i] + (rand() % 17 - 8) * lattice;
+        }
+        std::vector<SegmentIntersectionPair> correct_pairs;
+        for (int32_t i = 0; i < segment_count; i++)
+        {
+            for (int32_t j = i + 1; j < segment_count; j++)
+            {
+                if (SegmentIntersections_intersect(x1[i], y1[i], x2[i], y2[i], x1[j], y1[j], x2[j], y2[j]))
+                    correct_pairs.push_back({ i, j });
+            }
+        }
+        int32_t thread_count = 1 + test % 4;
+        SegmentIntersectionPair *pairs;
+        int64_t pair_count;
+        ASSERT_TRUE(SegmentIntersections_find(x1.data(), y1.data(), x2.data(), y2.data(), segment_count,
+            square_width * 4, thread_count, &pairs, &pair_count));
+        ASSERT_EQ((int64_t)correct_pairs.size(), pair_count);
+        for (int64_t i = 0; i < pair_count; i++)
+        {
+            EXPECT_EQ(correct_pairs[i].first_id, pairs[i].first_id);
+            EXPECT_EQ(correct_pairs[i].second_id, pairs[i].second_id);
+        }
+        free(pairs);
+    }
+}
@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+#include <tuple>
+#include "gtest/gtest.h"
+#include "voxel_traverser.h"
+#include "line_traverser.h"
+
+typedef std::tuple<int, int, int> Voxel;
+
+void collect_voxels_callback(int32_t x, int32_t y, int32_t z, void *user_data)
+{
+    std::vector<Voxel> *p_voxels = (std::vector<Voxel>*)user_data;
+    p_voxels->push_back(Voxel(x, y, z));
+}
+
+void collect_cells_2d_callback(int32_t x, int32_t y, void *user_data)
+{
+    std::vector<std::pair<int, int>> *p_cells = (std::vector<std::pair<int, int>>*)user_data;
+    p_cells->push_back(std::pair<int, int>(x, y));
+}
+
+// Projects voxels onto 2 axes, dropping repeated cells caused by steps along the third axis.
+std::vector<std::pair<int, int>> project_voxels(const std::vector<Voxel> &voxels, int axis1, int axis2)
+{
+    std::vector<std::pair<int, int>> cells;
+    for (const Voxel &voxel : voxels)
+    {
+        int coords[3] = { std::get<0>(voxel), std::get<1>(voxel), std::get<2>(voxel) };
+        std::pair<int, int> cell(coords[axis1], coords[axis2]);
+        if (cells.empty() || cells.back() != cell)
+            cells.push_back(cell);
+    }
+    return cells;
+}
+
+bool verify_voxel_traversal(int x1, int y1, int z1, int x2, int y2, int z2, int voxel_width)
+{
+    std::vector<Voxel> voxels;
+    VoxelTraverser_traverse_include_endpoints(x1, y1, z1, x2, y2, z2, voxel_width, collect_voxels_callback, &voxels);
+
+    int32_t end_x1, end_y1, end_z1, end_x2, end_y2, end_z2;
+    VoxelTraverser_get_endpoints(x1, y1, z1, x2, y2, z2, voxel_width,
+        &end_x1, &end_y1, &end_z1, &end_x2, &end_y2, &end_z2);
+    if (voxels.front() != Voxel(end_x1, end_y1, end_z1) || voxels.back() != Voxel(end_x2, end_y2, end_z2))
+        return false;
+
+    // Every step moves 1 voxel towards the end on at least one axis.
+    for (size_t i = 1; i < voxels.size(); i++)
+    {
+        int step_x = std::get<0>(voxels[i]) - std::get<0>(voxels[i - 1]);
+        int step_y = std::get<1>(voxels[i]) - std::get<1>(voxels[i - 1]);
+        int step_z = std::get<2>(voxels[i]) - std::get<2>(voxels[i - 1]);
+        if (abs(step_x) > 1 || abs(step_y) > 1 || abs(step_z) > 1 || (step_x == 0 && step_y == 0 && step_z == 0))
+            return false;
+        if (step_x * (x2 - x1) < 0 || step_y * (y2 - y1) < 0 || step_z * (z2 - z1) < 0)
+            return false;
+    }
+
+    // The line projected onto any 2 axes is the 2D line, so it must traverse the same cells as LineTraverser.
+    int start[3] = { x1, y1, z1 };
+    int end[3] = { x2, y2, z2 };
+    for (int axis1 = 0; axis1 < 3; axis1++)
+    {
+        for (int axis2 = axis1 + 1; axis2 < 3; axis2++)
+        {
+            std::vector<std::pair<int, int>> correct_cells;
+            LineTraverser_traverse_include_endpoints(start[axis1], start[axis2], end[axis1], end[axis2], voxel_width,
+                collect_cells_2d_callback, &correct_cells);
+            if (project_voxels(voxels, axis1, axis2) != correct_cells)
+                return false;
+        }
+    }
+
+    std::vector<Voxel> excluded_voxels;
+    VoxelTraverser_traverse_exclude_endpoints(x1, y1, z1, x2, y2, z2, voxel_width,
+        collect_voxels_callback, &excluded_voxels);
+    std::vector<Voxel> correct_excluded_voxels;
+    if (voxels.size() > 2)
+        correct_excluded_voxels.assign(voxels.begin() + 1, voxels.end() - 1);
+    return excluded_voxels == correct_excluded_voxels;
+}
+
+TEST(voxel_traverser_tests, VoxelTraverser)
+{
+    EXPECT_TRUE(verify_voxel_traversal(0, 0, 0, 0, 0, 0, 1));
+    EXPECT_TRUE(verify_voxel_traversal(1, 2, 3, 1, 2, 3, 4));
+    EXPECT_TRUE(verify_voxel_traversal(0, 0, 0, 10, 0, 0, 1));
+    EXPECT_TRUE(verify_voxel_traversal(0, 0, 10, 0, 0, 0, 1));
+    EXPECT_TRUE(verify_voxel_traversal(0, 0, 0, 12, 12, 12, 4));
+    EXPECT_TRUE(verify_voxel_traversal(12, 12, 12, 0, 0, 0, 4));
+    EXPECT_TRUE(verify_voxel_traversal(3, 5, 7, 40, 17, 2, 4));
+    EXPECT_TRUE(verify_voxel_traversal(4, 8, 12, 16, 8, 0, 4));
+
+    // A line going exactly through voxel corners steps all 3 axes at once.
+    std::vector<Voxel> voxels;
+    VoxelTraverser_traverse_include_endpoints(1, 1, 1, 31, 31, 31, 10, collect_voxels_callback, &voxels);
+    std::vector<Voxel> correct_voxels = { Voxel(0, 0, 0), Voxel(1, 1, 1), Voxel(2, 2, 2), Voxel(3, 3, 3) };
+    EXPECT_EQ(voxels, correct_voxels);
+
+    for (int i = 0; i < 2000; i++)
+    {
+        int x1 = rand() % 1000;
+        int y1 = rand() % 1000;
+        int z1 = rand() % 1000;
+        int x2 = rand() % 1000;
+        int y2 = rand() % 1000;
+        int z2 = rand() % 1000;
+        int voxel_width = 1 + rand() % 16;
+        EXPECT_TRUE(verify_voxel_traversal(x1, y1, z1, x2, y2, z2, voxel_width));
+        // Snap to the voxel grid to exercise exact ties between axes.
+        voxel_width = 1 + rand() % 4;
+        EXPECT_TRUE(verify_voxel_traversal(x1 / 50 * 4, y1 / 50 * 4, z1 / 50 * 4,
+            x2 / 50 * 4, y2 / 50 * 4, z2 / 50 * 4, voxel_width));
+    }
+}
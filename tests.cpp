@@ -3,9 +3,12 @@
 #include <utility>
 #include <vector>
 #include <functional>
+#include <algorithm>
 #include "gtest/gtest.h"
 #include "draw_line.h"
 #include "line_traverser.h"
+#include "line_traverser.hpp"
+#include "draw_line.hpp"
 
 #ifndef min
 #define min(a, b) (((a) < (b)) ? (a) : (b))
@@ -3411,6 +3414,992 @@ TEST(endpoint_test, DrawLine)
     }
 }
 
+void collect_cells_callback(int32_t x, int32_t y, void *user_data)
+{
+    std::vector<std::pair<int, int>> *p_cells = (std::vector<std::pair<int, int>>*)user_data;
+    p_cells->push_back(std::pair<int, int>(x, y));
+}
+
+typedef struct
+{
+    std::vector<std::pair<int, int>> cells;
+    bool spans_valid;
+    bool is_horizontal;
+} CollectSpansInfo;
+
+void collect_spans_callback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, void *user_data)
+{
+    CollectSpansInfo *p_info = (CollectSpansInfo*)user_data;
+    if ((p_info->is_horizontal && y1 != y2) || (!p_info->is_horizontal && x1 != x2))
+        p_info->spans_valid = false;
+    int step_x = (x2 >= x1) ? 1 : -1;
+    int step_y = (y2 >= y1) ? 1 : -1;
+    for (int y = y1; y != y2 + step_y; y += step_y)
+    {
+        for (int x = x1; x != x2 + step_x; x += step_x)
+            p_info->cells.push_back(std::pair<int, int>(x, y));
+    }
+}
+
+bool verify_spans(int x1, int y1, int x2, int y2, int square_width)
+{
+    std::vector<std::pair<int, int>> correct_cells;
+    CollectSpansInfo info;
+    info.spans_valid = true;
+    info.is_horizontal = abs(x2 - x1) >= abs(y2 - y1);
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+    LineTraverser_traverse_spans_include_endpoints(x1, y1, x2, y2, square_width, collect_spans_callback, &info);
+    if (!info.spans_valid || info.cells != correct_cells)
+        return false;
+
+    correct_cells.clear();
+    info.cells.clear();
+    LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+    LineTraverser_traverse_spans_exclude_endpoints(x1, y1, x2, y2, square_width, collect_spans_callback, &info);
+    return info.spans_valid && info.cells == correct_cells;
+}
+
+TEST(span_test, LineTraverser)
+{
+    for (int square_width = 1; square_width <= 8; square_width++)
+    {
+        for (int x2 = 0; x2 < 64; x2++)
+        {
+            for (int y2 = 0; y2 < 64; y2++)
+            {
+                EXPECT_TRUE(verify_spans(32, 32, x2, y2, square_width));
+                EXPECT_TRUE(verify_spans(29, 35, x2, y2, square_width));
+            }
+        }
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        for (int square_width = 1; square_width < 64; square_width *= 2)
+        {
+            int x1 = rand() % 4096;
+            int y1 = rand() % 4096;
+            int x2 = rand() % 4096;
+            int y2 = rand() % 4096;
+            EXPECT_TRUE(verify_spans(x1, y1, x2, y2, square_width));
+        }
+    }
+}
+
+bool verify_next_points(int x1, int y1, int x2, int y2, int square_width, int buffer_size)
+{
+    std::vector<std::pair<int, int>> correct_cells;
+    std::vector<std::pair<int, int>> test_cells;
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+
+    std::vector<int32_t> buffer_x(buffer_size);
+    std::vector<int32_t> buffer_y(buffer_size);
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    bool is_end = false;
+    while (!is_end)
+    {
+        int32_t count;
+        is_end = LineTraverser_next_points(&traverser, buffer_x.data(), buffer_y.data(), buffer_size, &count);
+        if (count > buffer_size || (!is_end && count != buffer_size))
+            return false;
+        for (int32_t i = 0; i < count; i++)
+            test_cells.push_back(std::pair<int, int>(buffer_x[i], buffer_y[i]));
+        if (test_cells.size() > correct_cells.size())
+            return false;
+    }
+    return test_cells == correct_cells;
+}
+
+TEST(next_points_test, LineTraverser)
+{
+    int buffer_sizes[] = {1, 2, 3, 7, 64};
+    for (int buffer_size : buffer_sizes)
+    {
+        for (int square_width = 1; square_width <= 8; square_width *= 2)
+        {
+            for (int x2 = 0; x2 < 64; x2 += 3)
+            {
+                for (int y2 = 0; y2 < 64; y2 += 3)
+                {
+                    EXPECT_TRUE(verify_next_points(32, 32, x2, y2, square_width, buffer_size));
+                    EXPECT_TRUE(verify_next_points(29, 35, x2, y2, square_width, buffer_size));
+                }
+            }
+        }
+        for (int i = 0; i < 200; i++)
+        {
+            int x1 = rand() % 4096;
+            int y1 = rand() % 4096;
+            int x2 = rand() % 4096;
+            int y2 = rand() % 4096;
+            EXPECT_TRUE(verify_next_points(x1, y1, x2, y2, 1 + rand() % 16, buffer_size));
+        }
+    }
+}
+
+bool verify_count(int x1, int y1, int x2, int y2, int square_width)
+{
+    std::vector<std::pair<int, int>> include_cells;
+    std::vector<std::pair<int, int>> exclude_cells;
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &include_cells);
+    LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &exclude_cells);
+    if (LineTraverser_count_include_endpoints(x1, y1, x2, y2, square_width) != (int64_t)include_cells.size())
+        return false;
+    if (LineTraverser_count_exclude_endpoints(x1, y1, x2, y2, square_width) != (int64_t)exclude_cells.size())
+        return false;
+
+    int32_t ep1x, ep1y, ep2x, ep2y;
+    LineTraverser_get_endpoints(x1, y1, x2, y2, square_width, &ep1x, &ep1y, &ep2x, &ep2y);
+    for (int i = 0; i < 8; i++)
+    {
+        int32_t rect_min_x = min(ep1x, ep2x) - 2 + rand() % (abs(ep2x - ep1x) + 4);
+        int32_t rect_min_y = min(ep1y, ep2y) - 2 + rand() % (abs(ep2y - ep1y) + 4);
+        int32_t rect_max_x = rect_min_x + rand() % (abs(ep2x - ep1x) + 4);
+        int32_t rect_max_y = rect_min_y + rand() % (abs(ep2y - ep1y) + 4);
+        int64_t include_count = 0;
+        for (std::pair<int, int> &cell : include_cells)
+        {
+            if (cell.first >= rect_min_x && cell.first <= rect_max_x &&
+                cell.second >= rect_min_y && cell.second <= rect_max_y)
+                include_count++;
+        }
+        int64_t exclude_count = 0;
+        for (std::pair<int, int> &cell : exclude_cells)
+        {
+            if (cell.first >= rect_min_x && cell.first <= rect_max_x &&
+                cell.second >= rect_min_y && cell.second <= rect_max_y)
+                exclude_count++;
+        }
+        if (LineTraverser_count_inside_rect_include_endpoints(x1, y1, x2, y2, square_width,
+            rect_min_x, rect_min_y, rect_max_x, rect_max_y) != include_count)
+            return false;
+        if (LineTraverser_count_inside_rect_exclude_endpoints(x1, y1, x2, y2, square_width,
+            rect_min_x, rect_min_y, rect_max_x, rect_max_y) != exclude_count)
+            return false;
+    }
+    return true;
+}
+
+TEST(count_test, LineTraverser)
+{
+    for (int square_width = 1; square_width <= 8; square_width++)
+    {
+        for (int x2 = 0; x2 < 64; x2++)
+        {
+            for (int y2 = 0; y2 < 64; y2++)
+            {
+                EXPECT_TRUE(verify_count(32, 32, x2, y2, square_width));
+                EXPECT_TRUE(verify_count(29, 35, x2, y2, square_width));
+            }
+        }
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        for (int square_width = 1; square_width < 64; square_width *= 2)
+        {
+            int x1 = rand() % 4096;
+            int y1 = rand() % 4096;
+            int x2 = rand() % 4096;
+            int y2 = rand() % 4096;
+            EXPECT_TRUE(verify_count(x1, y1, x2, y2, square_width));
+            // Lines with small slopes built from the grid have many diagonal steps.
+            x2 = x1 + (rand() % 64) * square_width;
+            y2 = y1 + (rand() % 64) * square_width;
+            EXPECT_TRUE(verify_count(x1, y1, x2, y2, square_width));
+            EXPECT_TRUE(verify_count(x2, y2, x1, y1, square_width));
+        }
+    }
+}
+
+bool traversers_equal(const LineTraverser &a, const LineTraverser &b)
+{
+    return a.clockwiseness == b.clockwiseness && a.dx_clockwiseness == b.dx_clockwiseness &&
+        a.dy_clockwiseness == b.dy_clockwiseness && a.x == b.x && a.y == b.y &&
+        a.dx_x == b.dx_x && a.dy_y == b.dy_y && a.end_x == b.end_x && a.end_y == b.end_y;
+}
+
+bool verify_seek(int x1, int y1, int x2, int y2, int square_width)
+{
+    std::vector<LineTraverser> states;
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    states.push_back(traverser);
+    while (!LineTraverser_is_end(&traverser))
+    {
+        LineTraverser_next(&traverser);
+        states.push_back(traverser);
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        int64_t start = rand() % states.size();
+        int64_t steps = rand() % (states.size() + 2);
+        LineTraverser test = states[start];
+        bool success = LineTraverser_seek(&test, steps);
+        if (success != (start + steps < (int64_t)states.size()))
+            return false;
+        if (!traversers_equal(test, success ? states[start + steps] : states[start]))
+            return false;
+
+        int32_t column = states[rand() % states.size()].x + (rand() % 3) - 1;
+        int32_t row = states[rand() % states.size()].y + (rand() % 3) - 1;
+        int64_t first_in_column = -1;
+        int64_t first_in_row = -1;
+        for (int64_t j = start; j < (int64_t)states.size(); j++)
+        {
+            if (first_in_column < 0 && states[j].x == column)
+                first_in_column = j;
+            if (first_in_row < 0 && states[j].y == row)
+                first_in_row = j;
+        }
+        test = states[start];
+        int64_t moved = LineTraverser_seek_column(&test, column);
+        if (moved != ((first_in_column < 0) ? -1 : (first_in_column - start)))
+            return false;
+        if (!traversers_equal(test, (first_in_column < 0) ? states[start] : states[first_in_column]))
+            return false;
+        test = states[start];
+        moved = LineTraverser_seek_row(&test, row);
+        if (moved != ((first_in_row < 0) ? -1 : (first_in_row - start)))
+            return false;
+        if (!traversers_equal(test, (first_in_row < 0) ? states[start] : states[first_in_row]))
+            return false;
+    }
+    return true;
+}
+
+TEST(seek_test, LineTraverser)
+{
+    for (int square_width = 1; square_width <= 8; square_width++)
+    {
+        for (int x2 = 0; x2 < 64; x2 += 2)
+        {
+            for (int y2 = 0; y2 < 64; y2 += 2)
+            {
+                EXPECT_TRUE(verify_seek(32, 32, x2, y2, square_width));
+                EXPECT_TRUE(verify_seek(29, 35, x2, y2, square_width));
+            }
+        }
+    }
+    for (int i = 0; i < 500; i++)
+    {
+        for (int square_width = 1; square_width < 64; square_width *= 2)
+        {
+            int x1 = rand() % 4096;
+            int y1 = rand() % 4096;
+            int x2 = rand() % 4096;
+            int y2 = rand() % 4096;
+            EXPECT_TRUE(verify_seek(x1, y1, x2, y2, square_width));
+            x2 = x1 + (rand() % 64) * square_width;
+            y2 = y1 + (rand() % 64) * square_width;
+            EXPECT_TRUE(verify_seek(x2, y2, x1, y1, square_width));
+        }
+    }
+}
+
+bool verify_template_traverse(int x1, int y1, int x2, int y2, int square_width)
+{
+    std::vector<std::pair<int, int>> correct_cells;
+    std::vector<std::pair<int, int>> test_cells;
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+    bool finished = line_traverser::traverse_include_endpoints(x1, y1, x2, y2, square_width,
+        [&](int32_t x, int32_t y) { test_cells.push_back(std::pair<int, int>(x, y)); });
+    if (!finished || test_cells != correct_cells)
+        return false;
+
+    // Stop part way through, the visitor should not be called again after returning false.
+    size_t stop_index = rand() % correct_cells.size();
+    test_cells.clear();
+    finished = line_traverser::traverse_include_endpoints(x1, y1, x2, y2, square_width,
+        [&](int32_t x, int32_t y) {
+            test_cells.push_back(std::pair<int, int>(x, y));
+            return test_cells.size() <= stop_index;
+        });
+    if (finished || test_cells.size() != stop_index + 1 ||
+        !std::equal(test_cells.begin(), test_cells.end(), correct_cells.begin()))
+        return false;
+
+    correct_cells.clear();
+    test_cells.clear();
+    LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+    finished = line_traverser::traverse_exclude_endpoints(x1, y1, x2, y2, square_width,
+        [&](int32_t x, int32_t y) { test_cells.push_back(std::pair<int, int>(x, y)); return true; });
+    return finished && test_cells == correct_cells;
+}
+
+TEST(template_test, LineTraverser)
+{
+    for (int square_width = 1; square_width <= 8; square_width *= 2)
+    {
+        for (int x2 = 0; x2 < 64; x2++)
+        {
+            for (int y2 = 0; y2 < 64; y2++)
+            {
+                EXPECT_TRUE(verify_template_traverse(32, 32, x2, y2, square_width));
+                EXPECT_TRUE(verify_template_traverse(29, 35, x2, y2, square_width));
+            }
+        }
+    }
+}
+
+bool verify_power_of_2_init(int x1, int y1, int x2, int y2, int square_shift)
+{
+    // Scaling the line and the grid by 3 doesn't change which grid squares are traversed, and
+    // square_width * 3 is not a power of 2, so it is initialized using division.
+    int square_width = 1 << square_shift;
+    LineTraverser shifted = LineTraverser_init_shift(x1, y1, x2, y2, square_shift);
+    LineTraverser dispatched = LineTraverser_init(x1, y1, x2, y2, square_width);
+    LineTraverser divided = LineTraverser_init(x1 * 3, y1 * 3, x2 * 3, y2 * 3, square_width * 3);
+    if (!traversers_equal(shifted, dispatched))
+        return false;
+    if (shifted.x != divided.x || shifted.y != divided.y || shifted.end_x != divided.end_x ||
+        shifted.end_y != divided.end_y || shifted.dx_x != divided.dx_x || shifted.dy_y != divided.dy_y)
+        return false;
+    if (shifted.clockwiseness * 9 != divided.clockwiseness ||
+        shifted.dx_clockwiseness * 9 != divided.dx_clockwiseness ||
+        shifted.dy_clockwiseness * 9 != divided.dy_clockwiseness)
+        return false;
+
+    int32_t shifted_endpoints[4], divided_endpoints[4];
+    LineTraverser_get_endpoints(x1, y1, x2, y2, square_width, &shifted_endpoints[0], &shifted_endpoints[1],
+        &shifted_endpoints[2], &shifted_endpoints[3]);
+    LineTraverser_get_endpoints(x1 * 3, y1 * 3, x2 * 3, y2 * 3, square_width * 3, &divided_endpoints[0],
+        &divided_endpoints[1], &divided_endpoints[2], &divided_endpoints[3]);
+    for (int i = 0; i < 4; i++)
+    {
+        if (shifted_endpoints[i] != divided_endpoints[i])
+            return false;
+    }
+    return true;
+}
+
+TEST(power_of_2_test, LineTraverser)
+{
+    for (int square_shift = 0; square_shift <= 8; square_shift++)
+    {
+        for (int i = 0; i < 2000; i++)
+        {
+            int x1 = rand() % 4096 - 2048;
+            int y1 = rand() % 4096 - 2048;
+            int x2 = rand() % 4096 - 2048;
+            int y2 = rand() % 4096 - 2048;
+            EXPECT_TRUE(verify_power_of_2_init(x1, y1, x2, y2, square_shift));
+            x1 -= x1 % (1 << square_shift);
+            y2 -= y2 % (1 << square_shift);
+            EXPECT_TRUE(verify_power_of_2_init(x1, y1, x2, y2, square_shift));
+            EXPECT_TRUE(verify_power_of_2_init(x2, y2, x1, y1, square_shift));
+        }
+    }
+}
+
+void collect_rows_callback(int32_t y, int32_t x_begin, int32_t x_end, void *user_data)
+{
+    std::vector<std::pair<int, std::pair<int, int>>> *p_rows = (std::vector<std::pair<int, std::pair<int, int>>>*)user_data;
+    p_rows->push_back(std::pair<int, std::pair<int, int>>(y, std::pair<int, int>(x_begin, x_end)));
+}
+
+std::vector<std::pair<int, std::pair<int, int>>> cells_to_rows(const std::vector<std::pair<int, int>> &cells)
+{
+    std::vector<std::pair<int, std::pair<int, int>>> rows;
+    for (const std::pair<int, int> &cell : cells)
+    {
+        if (rows.empty() || rows.back().first != cell.second)
+        {
+            rows.push_back(std::pair<int, std::pair<int, int>>(cell.second, std::pair<int, int>(cell.first, cell.first)));
+            continue;
+        }
+        rows.back().second.first = min(rows.back().second.first, cell.first);
+        rows.back().second.second = max(rows.back().second.second, cell.first);
+    }
+    return rows;
+}
+
+bool verify_rows(int x1, int y1, int x2, int y2, int square_width)
+{
+    std::vector<std::pair<int, int>> cells;
+    std::vector<std::pair<int, std::pair<int, int>>> rows;
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &cells);
+    LineTraverser_traverse_rows_include_endpoints(x1, y1, x2, y2, square_width, collect_rows_callback, &rows);
+    if (rows != cells_to_rows(cells))
+        return false;
+
+    cells.clear();
+    rows.clear();
+    LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &cells);
+    LineTraverser_traverse_rows_exclude_endpoints(x1, y1, x2, y2, square_width, collect_rows_callback, &rows);
+    return rows == cells_to_rows(cells);
+}
+
+TEST(row_test, LineTraverser)
+{
+    for (int square_width = 1; square_width <= 8; square_width++)
+    {
+        for (int x2 = 0; x2 < 64; x2++)
+        {
+            for (int y2 = 0; y2 < 64; y2++)
+            {
+                EXPECT_TRUE(verify_rows(32, 32, x2, y2, square_width));
+                EXPECT_TRUE(verify_rows(29, 35, x2, y2, square_width));
+            }
+        }
+    }
+}
+
+typedef struct
+{
+    std::vector<std::pair<int, int>> cells;
+    size_t stop_index;
+} TraverseUntilInfo;
+
+bool traverse_until_visitor(int32_t x, int32_t y, void *user_data)
+{
+    TraverseUntilInfo *p_info = (TraverseUntilInfo*)user_data;
+    p_info->cells.push_back(std::pair<int, int>(x, y));
+    return p_info->cells.size() <= p_info->stop_index;
+}
+
+bool verify_traverse_until(int x1, int y1, int x2, int y2, int square_width, bool include_endpoints)
+{
+    std::vector<std::pair<int, int>> correct_cells;
+    if (include_endpoints)
+        LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+    else
+        LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+
+    // Try stopping at every grid square, and never stopping.
+    for (size_t stop_index = 0; stop_index <= correct_cells.size(); stop_index++)
+    {
+        TraverseUntilInfo info;
+        info.stop_index = stop_index;
+        int64_t count = -1;
+        int32_t last_x = INT32_MIN, last_y = INT32_MIN;
+        bool stopped;
+        if (include_endpoints)
+            stopped = LineTraverser_traverse_until_include_endpoints(x1, y1, x2, y2, square_width,
+                traverse_until_visitor, &info, &count, &last_x, &last_y);
+        else
+            stopped = LineTraverser_traverse_until_exclude_endpoints(x1, y1, x2, y2, square_width,
+                traverse_until_visitor, &info, &count, &last_x, &last_y);
+        size_t correct_count = min(stop_index + 1, correct_cells.size());
+        if (stopped != (stop_index < correct_cells.size()) || count != (int64_t)correct_count)
+            return false;
+        if (info.cells.size() != correct_count ||
+            !std::equal(info.cells.begin(), info.cells.end(), correct_cells.begin()))
+            return false;
+        if (correct_count > 0 && (last_x != info.cells.back().first || last_y != info.cells.back().second))
+            return false;
+    }
+    return true;
+}
+
+TEST(traverse_until_test, LineTraverser)
+{
+    for (int square_width = 1; square_width <= 8; square_width *= 2)
+    {
+        for (int x2 = 0; x2 < 64; x2 += 3)
+        {
+            for (int y2 = 0; y2 < 64; y2 += 3)
+            {
+                EXPECT_TRUE(verify_traverse_until(32, 32, x2, y2, square_width, true));
+                EXPECT_TRUE(verify_traverse_until(29, 35, x2, y2, square_width, false));
+            }
+        }
+    }
+}
+
+typedef struct
+{
+    int x1, y1, x2, y2, square_width;
+    std::vector<std::pair<int, int>> cells;
+    int64_t t_previous;
+    int64_t t_denominator;
+    bool valid;
+} ParametricInfo;
+
+void parametric_callback(int32_t x, int32_t y, int64_t t_enter, int64_t t_exit, int64_t t_denominator, void *user_data)
+{
+    ParametricInfo *p_info = (ParametricInfo*)user_data;
+    if (!p_info->cells.empty() && t_enter != p_info->t_previous)
+        p_info->valid = false;
+    if (t_exit < t_enter || t_enter < 0 || t_exit > t_denominator)
+        p_info->valid = false;
+    p_info->cells.push_back(std::pair<int, int>(x, y));
+    p_info->t_previous = t_exit;
+    p_info->t_denominator = t_denominator;
+
+    // The middle of the part of the line inside the grid square must be inside the grid square.
+    if (t_exit > t_enter)
+    {
+        double t = ((double)t_enter + (double)t_exit) * 0.5 / (double)t_denominator;
+        double px = p_info->x1 + t * (p_info->x2 - p_info->x1);
+        double py = p_info->y1 + t * (p_info->y2 - p_info->y1);
+        double w = p_info->square_width;
+        if (px < x * w - 0.0001 || px > (x + 1) * w + 0.0001 || py < y * w - 0.0001 || py > (y + 1) * w + 0.0001)
+            p_info->valid = false;
+    }
+}
+
+bool verify_parametric(int x1, int y1, int x2, int y2, int square_width)
+{
+    std::vector<std::pair<int, int>> correct_cells;
+    ParametricInfo info;
+    info.x1 = x1;
+    info.y1 = y1;
+    info.x2 = x2;
+    info.y2 = y2;
+    info.square_width = square_width;
+    info.valid = true;
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+    LineTraverser_traverse_parametric_include_endpoints(x1, y1, x2, y2, square_width, parametric_callback, &info);
+    if (!info.valid || info.cells != correct_cells || info.t_previous != info.t_denominator)
+        return false;
+
+    correct_cells.clear();
+    info.cells.clear();
+    LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &correct_cells);
+    LineTraverser_traverse_parametric_exclude_endpoints(x1, y1, x2, y2, square_width, parametric_callback, &info);
+    return info.valid && info.cells == correct_cells;
+}
+
+TEST(parametric_test, LineTraverser)
+{
+    for (int square_width = 1; square_width <= 8; square_width++)
+    {
+        for (int x2 = 0; x2 < 64; x2++)
+        {
+            for (int y2 = 0; y2 < 64; y2++)
+            {
+                EXPECT_TRUE(verify_parametric(32, 32, x2, y2, square_width));
+                EXPECT_TRUE(verify_parametric(29, 35, x2, y2, square_width));
+            }
+        }
+    }
+}
+
+bool verify_compact(int x1, int y1, int x2, int y2, int square_width)
+{
+    if (!LineTraverserCompact_fits(x1, y1, x2, y2, square_width))
+        return false;
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    LineTraverserCompact compact = LineTraverserCompact_init(x1, y1, x2, y2, square_width);
+    while (true)
+    {
+        int32_t x, y, compact_x, compact_y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        LineTraverserCompact_get_point(&compact, &compact_x, &compact_y);
+        if (x != compact_x || y != compact_y)
+            return false;
+        if (LineTraverser_is_end(&traverser) != LineTraverserCompact_is_end(&compact))
+            return false;
+        if (LineTraverser_is_end(&traverser))
+            return true;
+        LineTraverser_next(&traverser);
+        LineTraverserCompact_next(&compact);
+    }
+}
+
+TEST(compact_test, LineTraverser)
+{
+    EXPECT_LE(sizeof(LineTraverserCompact), 24u);
+    for (int square_width = 1; square_width <= 8; square_width++)
+    {
+        for (int x2 = 0; x2 < 64; x2 += 3)
+        {
+            for (int y2 = 0; y2 < 64; y2 += 3)
+            {
+                EXPECT_TRUE(verify_compact(32, 32, x2, y2, square_width));
+                EXPECT_TRUE(verify_compact(29, 35, x2, y2, square_width));
+            }
+        }
+    }
+    for (int i = 0; i < 2000; i++)
+    {
+        int x1 = rand() % 4096;
+        int y1 = rand() % 4096;
+        int x2 = rand() % 4096;
+        int y2 = rand() % 4096;
+        int square_width = 1 + rand() % 64;
+        EXPECT_TRUE(verify_compact(x1, y1, x2, y2, square_width));
+    }
+    EXPECT_FALSE(LineTraverserCompact_fits(0, 0, 1 << 20, 0, 1 << 10));
+    EXPECT_FALSE(LineTraverserCompact_fits(2141303910, 58317573, 372790187, 792163179, 2017579061));
+    EXPECT_FALSE(LineTraverserCompact_fits(0, 0, 1, 1, INT32_MAX));
+    EXPECT_TRUE(LineTraverserCompact_fits(0, 0, 0, 1, INT32_MAX / 2));
+    EXPECT_FALSE(LineTraverserCompact_fits(0, 0, 1, 1, INT32_MAX / 2));
+
+    // Huge square widths must not overflow the fits test and run on the 32 bit state.
+    std::vector<std::pair<int, int>> wide_cells;
+    LineTraverser_traverse_include_endpoints(2141303910, 58317573, 372790187, 792163179, 2017579061,
+        collect_cells_callback, &wide_cells);
+    ASSERT_EQ(2u, wide_cells.size());
+    EXPECT_EQ(std::make_pair(1, 0), wide_cells[0]);
+    EXPECT_EQ(std::make_pair(0, 0), wide_cells[1]);
+    for (int i = 0; i < 20000; i++)
+    {
+        int x1 = rand();
+        int y1 = rand();
+        int x2 = rand();
+        int y2 = rand();
+        int square_width = (1 << 30) + rand() % (1 << 30);
+        std::vector<std::pair<int, int>> large_cells;
+        LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &large_cells);
+        LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+        std::vector<std::pair<int, int>> expected_cells;
+        while (true)
+        {
+            int32_t x, y;
+            LineTraverser_get_point(&traverser, &x, &y);
+            expected_cells.push_back(std::make_pair(x, y));
+            if (LineTraverser_is_end(&traverser))
+                break;
+            LineTraverser_next(&traverser);
+        }
+        EXPECT_EQ(expected_cells, large_cells);
+    }
+
+    // The clockwiseness of this line does not fit in 32 bits, so it must take the 64 bit path.
+    std::vector<std::pair<int, int>> cells;
+    LineTraverser_traverse_include_endpoints(0, 0, 2000000000, 7000, 1000, collect_cells_callback, &cells);
+    EXPECT_EQ((int64_t)cells.size(), LineTraverser_count_include_endpoints(0, 0, 2000000000, 7000, 1000));
+    EXPECT_EQ(cells.back().first, 1999999);
+    EXPECT_EQ(cells.back().second, 6);
+    std::vector<std::pair<int, int>> excluded_cells;
+    LineTraverser_traverse_exclude_endpoints(0, 0, 2000000000, 7000, 1000, collect_cells_callback, &excluded_cells);
+    EXPECT_EQ(excluded_cells.size() + 2, cells.size());
+}
+
+bool verify_clip_to_rect(int x1, int y1, int x2, int y2, int square_width,
+    int rect_min_x, int rect_min_y, int rect_max_x, int rect_max_y)
+{
+    std::vector<std::pair<int, int>> cells;
+    std::vector<std::pair<int, int>> correct_cells;
+    LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, square_width, collect_cells_callback, &cells);
+    for (const std::pair<int, int> &cell : cells)
+    {
+        if (cell.first >= rect_min_x && cell.first <= rect_max_x && cell.second >= rect_min_y && cell.second <= rect_max_y)
+            correct_cells.push_back(cell);
+    }
+
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+    LineTraverser original = traverser;
+    if (!LineTraverser_clip_to_rect(&traverser, rect_min_x, rect_min_y, rect_max_x, rect_max_y))
+        return correct_cells.empty() && traversers_equal(traverser, original);
+    std::vector<std::pair<int, int>> test_cells;
+    while (test_cells.size() <= correct_cells.size())
+    {
+        int32_t x, y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        test_cells.push_back(std::pair<int, int>(x, y));
+        if (LineTraverser_is_end(&traverser))
+            break;
+        LineTraverser_next(&traverser);
+    }
+    return test_cells == correct_cells;
+}
+
+TEST(clip_to_rect_test, LineTraverser)
+{
+    for (int i = 0; i < 5000; i++)
+    {
+        int x1 = rand() % 1024;
+        int y1 = rand() % 1024;
+        int x2 = rand() % 1024;
+        int y2 = rand() % 1024;
+        int square_width = 1 + rand() % 16;
+        int rect_min_x = rand() % 80 - 10;
+        int rect_min_y = rand() % 80 - 10;
+        int rect_max_x = rect_min_x + rand() % 40;
+        int rect_max_y = rect_min_y + rand() % 40;
+        EXPECT_TRUE(verify_clip_to_rect(x1, y1, x2, y2, square_width, rect_min_x, rect_min_y, rect_max_x, rect_max_y));
+        EXPECT_TRUE(verify_clip_to_rect(x1, y1, x1, y2, square_width, rect_min_x, rect_min_y, rect_max_x, rect_max_y));
+        EXPECT_TRUE(verify_clip_to_rect(x1, y1, x2, y1, square_width, rect_min_x, rect_min_y, rect_max_x, rect_max_y));
+    }
+}
+
+TEST(end_where_reached_test, LineTraverser)
+{
+    // The end grid square of this line is y = -3 while it starts at y = -2 and goes down, so it never stops.
+    LineTraverser traverser = LineTraverser_init(-10, -10, -10, -8, 4);
+    EXPECT_EQ(traverser.end_y, -3);
+    LineTraverser_end_where_reached(&traverser, -10, -10, -10, -8, 4);
+    EXPECT_EQ(traverser.end_y, -2);
+    EXPECT_TRUE(LineTraverser_is_end(&traverser));
+
+    for (int i = 0; i < 5000; i++)
+    {
+        int square_width = 1 + rand() % 20;
+        int range = 100 * square_width;
+        int x1 = rand() % (2 * range) - range;
+        int y1 = rand() % (2 * range) - range;
+        int x2 = rand() % (2 * range) - range;
+        int y2 = rand() % (2 * range) - range;
+        LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, square_width);
+        LineTraverser moved = traverser;
+        LineTraverser_end_where_reached(&moved, x1, y1, x2, y2, square_width);
+        if (x1 >= 0 && y1 >= 0 && x2 >= 0 && y2 >= 0)
+        {
+            EXPECT_EQ(moved.end_x, traverser.end_x);
+            EXPECT_EQ(moved.end_y, traverser.end_y);
+        }
+        // The steps reach the moved end, which is at most one grid square past the end on each axis.
+        EXPECT_LE(abs(moved.end_x - traverser.end_x), 1);
+        EXPECT_LE(abs(moved.end_y - traverser.end_y), 1);
+        int steps = 0;
+        while (!LineTraverser_is_end(&moved) && steps <= 4 * range)
+        {
+            LineTraverser_next(&moved);
+            steps++;
+        }
+        EXPECT_TRUE(LineTraverser_is_end(&moved));
+    }
+}
+
+typedef struct
+{
+    uint32_t *pixels;
+    int width, height;
+} CheckedPixelInfo;
+
+void checked_pixel_setter(int32_t x, int32_t y, void *user_data)
+{
+    CheckedPixelInfo *p_info = (CheckedPixelInfo*)user_data;
+    if (x >= 0 && x < p_info->width && y >= 0 && y < p_info->height)
+        p_info->pixels[y * p_info->width + x] = 1;
+}
+
+/// Traverses a line with negative coordinates to the grid square its steps reach, which drawline ends at.
+/// @returns true if the traversal ended within max_steps, false otherwise.
+bool traverse_negative_line(int x1, int y1, int x2, int y2, int pixel_width, bool include_endpoints,
+    CheckedPixelInfo *p_info, int max_steps)
+{
+    LineTraverser traverser = LineTraverser_init(x1, y1, x2, y2, pixel_width);
+    LineTraverser_end_where_reached(&traverser, x1, y1, x2, y2, pixel_width);
+    if (include_endpoints)
+        checked_pixel_setter(traverser.x, traverser.y, p_info);
+    for (int steps = 0; !LineTraverser_is_end(&traverser); steps++)
+    {
+        if (steps == max_steps)
+            return false;
+        LineTraverser_next(&traverser);
+        if (include_endpoints || !LineTraverser_is_end(&traverser))
+            checked_pixel_setter(traverser.x, traverser.y, p_info);
+    }
+    return true;
+}
+
+bool verify_clipped_drawline(int x1, int y1, int x2, int y2, int pixel_width, int width, int height,
+    bool include_endpoints)
+{
+    std::vector<uint32_t> correct_pixels(width * height);
+    std::vector<uint32_t> pixels(width * height);
+    CheckedPixelInfo info = { correct_pixels.data(), width, height };
+    if (x1 < 0 || y1 < 0 || x2 < 0 || y2 < 0)
+    {
+        // Every line stops within the Manhattan distance between its grid squares, plus one per axis.
+        int max_steps = abs(x2 / pixel_width - x1 / pixel_width) + abs(y2 / pixel_width - y1 / pixel_width) + 2;
+        if (!traverse_negative_line(x1, y1, x2, y2, pixel_width, include_endpoints, &info, max_steps))
+            return false;
+        if (include_endpoints)
+            drawline_include_endpoints(x1, y1, x2, y2, pixel_width, 1, pixels.data(), width, height);
+        else
+            drawline_exclude_endpoints(x1, y1, x2, y2, pixel_width, 1, pixels.data(), width, height);
+    }
+    else if (include_endpoints)
+    {
+        LineTraverser_traverse_include_endpoints(x1, y1, x2, y2, pixel_width, checked_pixel_setter, &info);
+        drawline_include_endpoints(x1, y1, x2, y2, pixel_width, 1, pixels.data(), width, height);
+    }
+    else
+    {
+        LineTraverser_traverse_exclude_endpoints(x1, y1, x2, y2, pixel_width, checked_pixel_setter, &info);
+        drawline_exclude_endpoints(x1, y1, x2, y2, pixel_width, 1, pixels.data(), width, height);
+    }
+    return pixels == correct_pixels;
+}
+
+TEST(clipped_drawline_test, DrawLine)
+{
+    for (int i = 0; i < 2000; i++)
+    {
+        // Long lines that cross a small image, and short lines near its edges.
+        int pixel_width = 1 + rand() % 300;
+        int x1 = rand() % (200 * pixel_width);
+        int y1 = rand() % (200 * pixel_width);
+        int x2 = rand() % (200 * pixel_width);
+        int y2 = rand() % (200 * pixel_width);
+        EXPECT_TRUE(verify_clipped_drawline(x1, y1, x2, y2, pixel_width, 64, 48, true));
+        EXPECT_TRUE(verify_clipped_drawline(x1, y1, x2, y2, pixel_width, 64, 48, false));
+        EXPECT_TRUE(verify_clipped_drawline(x1 % (70 * pixel_width), y1 % (50 * pixel_width),
+            x2 % (70 * pixel_width), y2 % (50 * pixel_width), pixel_width, 64, 48, false));
+        EXPECT_TRUE(verify_clipped_drawline(x1 - 40 * pixel_width, y1, x2, y2, pixel_width, 64, 48, true));
+    }
+
+    // Lines with negative endpoints are clipped like any other line, rather than traversed in full. Some of them
+    // would never reach the grid square of their end without LineTraverser_end_where_reached().
+    for (int i = 0; i < 2000; i++)
+    {
+        int pixel_width = 1 + rand() % 20;
+        int range = 200 * pixel_width;
+        int x1 = rand() % (2 * range) - range;
+        int y1 = rand() % (2 * range) - range;
+        int x2 = rand() % (2 * range) - range;
+        int y2 = rand() % (2 * range) - range;
+        EXPECT_TRUE(verify_clipped_drawline(x1, y1, x2, y2, pixel_width, 64, 48, true));
+        EXPECT_TRUE(verify_clipped_drawline(x1, y1, x2, y2, pixel_width, 64, 48, false));
+    }
+}
+
+template <typename Pixel, typename Blend>
+bool verify_template_drawline(int x1, int y1, int x2, int y2, int pixel_width, int width, int height,
+    bool include_endpoints, const Blend &blend)
+{
+    // Every pixel that the C function sets is blended exactly once.
+    std::vector<uint32_t> drawn((size_t)width * height, 0);
+    if (include_endpoints)
+        drawline_include_endpoints(x1, y1, x2, y2, pixel_width, 1, drawn.data(), width, height);
+    else
+        drawline_exclude_endpoints(x1, y1, x2, y2, pixel_width, 1, drawn.data(), width, height);
+    Pixel color = static_cast<Pixel>(rand());
+    std::vector<Pixel> pixels((size_t)width * height), correct_pixels((size_t)width * height);
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        pixels[i] = static_cast<Pixel>(rand());
+        correct_pixels[i] = drawn[i] ? blend(pixels[i], color) : pixels[i];
+    }
+    if (include_endpoints)
+        draw_line::draw_include_endpoints(x1, y1, x2, y2, pixel_width, color, pixels.data(), width, height, blend);
+    else
+        draw_line::draw_exclude_endpoints(x1, y1, x2, y2, pixel_width, color, pixels.data(), width, height, blend);
+    return pixels == correct_pixels;
+}
+
+TEST(template_drawline_test, DrawLine)
+{
+    for (int i = 0; i < 1000; i++)
+    {
+        // Short pixels make long rows, which go through the SIMD kernels.
+        int pixel_width = 1 + rand() % ((i % 2) ? 4 : 300);
+        int x1 = rand() % (100 * pixel_width) - 20 * pixel_width;
+        int y1 = rand() % (70 * pixel_width);
+        int x2 = rand() % (100 * pixel_width);
+        int y2 = (i % 3 == 0) ? y1 : rand() % (70 * pixel_width);
+        bool include_endpoints = i % 4 < 2;
+        EXPECT_TRUE(verify_template_drawline<uint32_t>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Overwrite()));
+        EXPECT_TRUE(verify_template_drawline<uint32_t>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::AlphaBlend()));
+        EXPECT_TRUE(verify_template_drawline<uint8_t>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Add()));
+        EXPECT_TRUE(verify_template_drawline<uint8_t>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Max()));
+        EXPECT_TRUE(verify_template_drawline<uint16_t>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Add()));
+        EXPECT_TRUE(verify_template_drawline<uint16_t>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Max()));
+        EXPECT_TRUE(verify_template_drawline<int16_t>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Add()));
+        EXPECT_TRUE(verify_template_drawline<float>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Add()));
+        EXPECT_TRUE(verify_template_drawline<float>(x1, y1, x2, y2, pixel_width, 80, 48, include_endpoints,
+            draw_line::Lerp{ 0.25f }));
+    }
+
+    draw_line::AlphaBlend alpha_blend;
+    EXPECT_EQ(0x12345678u, alpha_blend(0x12345678u, 0x00ABCDEFu));
+    EXPECT_EQ(0xFFABCDEFu, alpha_blend(0x12345678u, 0xFFABCDEFu));
+    EXPECT_EQ(0x80404040u, alpha_blend(0x00000000u, 0x80808080u));
+    EXPECT_EQ(0xFF404040u, alpha_blend(0xFF000000u, 0x80808080u));
+    draw_line::Add add;
+    EXPECT_EQ(255, add((uint8_t)200, (uint8_t)100));
+    EXPECT_EQ(-32768, add((int16_t)-30000, (int16_t)-30000));
+}
+
+typedef struct
+{
+    int32_t x, y;
+    int64_t t_enter, t_exit, t_denominator;
+} ParametricCell;
+
+void collect_parametric_cells_callback(int32_t x, int32_t y, int64_t t_enter, int64_t t_exit,
+    int64_t t_denominator, void *user_data)
+{
+    std::vector<ParametricCell> *p_cells = (std::vector<ParametricCell>*)user_data;
+    p_cells->push_back({ x, y, t_enter, t_exit, t_denominator });
+}
+
+std::vector<std::pair<int, int>> collect_traverser_cells(LineTraverser traverser)
+{
+    std::vector<std::pair<int, int>> cells;
+    while (true)
+    {
+        int32_t x, y;
+        LineTraverser_get_point(&traverser, &x, &y);
+        cells.push_back(std::pair<int, int>(x, y));
+        if (LineTraverser_is_end(&traverser))
+            return cells;
+        LineTraverser_next(&traverser);
+    }
+}
+
+bool verify_init_range(int x1, int y1, int x2, int y2, int square_width,
+    int64_t t_begin_numerator, int64_t t_begin_denominator, int64_t t_end_numerator, int64_t t_end_denominator)
+{
+    std::vector<ParametricCell> all_cells;
+    LineTraverser_traverse_parametric_include_endpoints(x1, y1, x2, y2, square_width,
+        collect_parametric_cells_callback, &all_cells);
+
+    // The range starts in the last grid square entered at or before t_begin,
+    // and ends in the last grid square entered strictly before t_end.
+    std::vector<std::pair<int, int>> correct_cells;
+    if (t_end_numerator * t_begin_denominator >= t_begin_numerator * t_end_denominator)
+    {
+        size_t first = 0, last = 0;
+        for (size_t i = 1; i < all_cells.size(); i++)
+        {
+            if (all_cells[i].t_enter * t_begin_denominator <= t_begin_numerator * all_cells[i].t_denominator)
+                first = i;
+            if (all_cells[i].t_enter * t_end_denominator < t_end_numerator * all_cells[i].t_denominator)
+                last = i;
+        }
+        for (size_t i = first; i <= last; i++)
+            correct_cells.push_back(std::pair<int, int>(all_cells[i].x, all_cells[i].y));
+    }
+
+    LineTraverser traverser;
+    if (!LineTraverser_init_range(&traverser, x1, y1, x2, y2, square_width,
+        t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator))
+        return correct_cells.empty();
+    return collect_traverser_cells(traverser) == correct_cells;
+}
+
+TEST(init_range_test, LineTraverser)
+{
+    for (int i = 0; i < 4000; i++)
+    {
+        int x1 = rand() % 1024;
+        int y1 = rand() % 1024;
+        int x2 = rand() % 1024;
+        int y2 = rand() % 1024;
+        int square_width = 1 + rand() % 16;
+        int64_t t_begin_denominator = 1 + rand() % 64;
+        int64_t t_end_denominator = 1 + rand() % 64;
+        int64_t t_begin_numerator = rand() % (t_begin_denominator + 1);
+        int64_t t_end_numerator = rand() % (t_end_denominator + 1);
+        EXPECT_TRUE(verify_init_range(x1, y1, x2, y2, square_width,
+            t_begin_numerator, t_begin_denominator, t_end_numerator, t_end_denominator));
+        // Parameters exactly on grid boundaries, like a rectangle aligned with the grid.
+        int64_t dx = abs(x2 - x1);
+        if (dx != 0)
+        {
+            int64_t t_begin = (square_width - x1 % square_width) + square_width * (rand() % 4);
+            EXPECT_TRUE(verify_init_range(x1, y1, x2, y2, square_width, t_begin, dx, dx, dx));
+            EXPECT_TRUE(verify_init_range(x1, y1, x2, y2, square_width, 0, 1, t_begin, dx));
+            EXPECT_TRUE(verify_init_range(x1, y1, x2, y2, square_width, t_begin, dx, t_begin, dx));
+        }
+    }
+    EXPECT_TRUE(verify_init_range(5, 5, 5, 5, 4, 0, 1, 1, 1));
+    EXPECT_TRUE(verify_init_range(3, 5, 40, 17, 4, -3, 1, 5, 1));
+    EXPECT_TRUE(verify_init_range(3, 5, 40, 17, 4, 2, 3, 1, 3));
+}
+
 int main(int argc, char* argv[])
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,161 @@
+
+/// voxel_traverser.c
+/// Provides functions for traversing a line over a 3D grid of voxels, where the starting and ending points
+/// have sub-voxel coordinates.
+
+#include "voxel_traverser.h"
+#include <stdlib.h>
+
+/// Sets up one axis of a voxel traverser the same way LineTraverser_init() does.
+/// Writes the voxel coordinates, the distance to the first boundary, and returns true if the starting
+/// point is on a boundary and the voxel was moved back by one.
+bool voxel_traverser_init_axis(int32_t v1, int32_t v2, int32_t voxel_width,
+    int32_t *out_v, int32_t *out_end_v, int32_t *out_step, int32_t *out_dist)
+{
+    int32_t dv = v2 - v1;
+    int32_t local_v = v1 % voxel_width;
+    *out_step = (dv >= 0) ? 1 : -1;
+    *out_dist = abs((dv >= 0) ? (voxel_width - local_v) : local_v);
+    *out_v = v1 / voxel_width;
+    *out_end_v = v2 / voxel_width;
+    if (dv < 0)
+    {
+        if (local_v == 0)
+        {
+            (*out_v)--;
+            return true;
+        }
+    }
+    else if (dv > 0)
+    {
+        if ((v2 % voxel_width) == 0)
+            (*out_end_v)--;
+    }
+    return false;
+}
+
+VoxelTraverser VoxelTraverser_init(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width)
+{
+    VoxelTraverser traverser;
+    int64_t abs_dx = abs(x2 - x1);
+    int64_t abs_dy = abs(y2 - y1);
+    int64_t abs_dz = abs(z2 - z1);
+    int32_t x_dist, y_dist, z_dist;
+    bool x_moved = voxel_traverser_init_axis(x1, x2, voxel_width, &traverser.x, &traverser.end_x,
+        &traverser.dx_x, &x_dist);
+    bool y_moved = voxel_traverser_init_axis(y1, y2, voxel_width, &traverser.y, &traverser.end_y,
+        &traverser.dy_y, &y_dist);
+    bool z_moved = voxel_traverser_init_axis(z1, z2, voxel_width, &traverser.z, &traverser.end_z,
+        &traverser.dz_z, &z_dist);
+
+    // Each clockwiseness is the 2D one from LineTraverser_init(), for the line projected onto two axes.
+    // For the (a, b) pair, a positive value means the a boundary is reached first, 0 means both at once.
+    traverser.clockwiseness_xy = abs_dx * y_dist - abs_dy * x_dist;
+    traverser.clockwiseness_xz = abs_dx * z_dist - abs_dz * x_dist;
+    traverser.clockwiseness_yz = abs_dy * z_dist - abs_dz * y_dist;
+    traverser.dx_clockwiseness_xy = -abs_dy * voxel_width;
+    traverser.dy_clockwiseness_xy = abs_dx * voxel_width;
+    traverser.dx_clockwiseness_xz = -abs_dz * voxel_width;
+    traverser.dz_clockwiseness_xz = abs_dx * voxel_width;
+    traverser.dy_clockwiseness_yz = -abs_dz * voxel_width;
+    traverser.dz_clockwiseness_yz = abs_dy * voxel_width;
+
+    if (x_moved)
+    {
+        traverser.clockwiseness_xy += traverser.dx_clockwiseness_xy;
+        traverser.clockwiseness_xz += traverser.dx_clockwiseness_xz;
+    }
+    if (y_moved)
+    {
+        traverser.clockwiseness_xy += traverser.dy_clockwiseness_xy;
+        traverser.clockwiseness_yz += traverser.dy_clockwiseness_yz;
+    }
+    if (z_moved)
+    {
+        traverser.clockwiseness_xz += traverser.dz_clockwiseness_xz;
+        traverser.clockwiseness_yz += traverser.dz_clockwiseness_yz;
+    }
+    return traverser;
+}
+
+bool VoxelTraverser_is_end(const VoxelTraverser *p_traverser)
+{
+    return p_traverser->x == p_traverser->end_x &&
+        p_traverser->y == p_traverser->end_y &&
+        p_traverser->z == p_traverser->end_z;
+}
+
+void VoxelTraverser_get_point(const VoxelTraverser *p_traverser, int32_t *out_x, int32_t *out_y, int32_t *out_z)
+{
+    *out_x = p_traverser->x;
+    *out_y = p_traverser->y;
+    *out_z = p_traverser->z;
+}
+
+void VoxelTraverser_next(VoxelTraverser *p_traverser)
+{
+    int64_t old_clockwiseness_xy = p_traverser->clockwiseness_xy;
+    int64_t old_clockwiseness_xz = p_traverser->clockwiseness_xz;
+    int64_t old_clockwiseness_yz = p_traverser->clockwiseness_yz;
+    if (old_clockwiseness_xy >= 0 && old_clockwiseness_xz >= 0)
+    {
+        p_traverser->x += p_traverser->dx_x;
+        p_traverser->clockwiseness_xy += p_traverser->dx_clockwiseness_xy;
+        p_traverser->clockwiseness_xz += p_traverser->dx_clockwiseness_xz;
+    }
+    if (old_clockwiseness_xy <= 0 && old_clockwiseness_yz >= 0)
+    {
+        p_traverser->y += p_traverser->dy_y;
+        p_traverser->clockwiseness_xy += p_traverser->dy_clockwiseness_xy;
+        p_traverser->clockwiseness_yz += p_traverser->dy_clockwiseness_yz;
+    }
+    if (old_clockwiseness_xz <= 0 && old_clockwiseness_yz <= 0)
+    {
+        p_traverser->z += p_traverser->dz_z;
+        p_traverser->clockwiseness_xz += p_traverser->dz_clockwiseness_xz;
+        p_traverser->clockwiseness_yz += p_traverser->dz_clockwiseness_yz;
+    }
+}
+
+void VoxelTraverser_get_endpoints(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width, int32_t *out_x1, int32_t *out_y1, int32_t *out_z1,
+    int32_t *out_x2, int32_t *out_y2, int32_t *out_z2)
+{
+    int32_t step, dist;
+    voxel_traverser_init_axis(x1, x2, voxel_width, out_x1, out_x2, &step, &dist);
+    voxel_traverser_init_axis(y1, y2, voxel_width, out_y1, out_y2, &step, &dist);
+    voxel_traverser_init_axis(z1, z2, voxel_width, out_z1, out_z2, &step, &dist);
+}
+
+void VoxelTraverser_traverse_include_endpoints(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width, VoxelTraverserCallback callback, void *user_data)
+{
+    VoxelTraverser traverser = VoxelTraverser_init(x1, y1, z1, x2, y2, z2, voxel_width);
+    while (true)
+    {
+        int32_t x, y, z;
+        VoxelTraverser_get_point(&traverser, &x, &y, &z);
+        callback(x, y, z, user_data);
+        if (VoxelTraverser_is_end(&traverser))
+            break;
+        VoxelTraverser_next(&traverser);
+    }
+}
+
+void VoxelTraverser_traverse_exclude_endpoints(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width, VoxelTraverserCallback callback, void *user_data)
+{
+    VoxelTraverser traverser = VoxelTraverser_init(x1, y1, z1, x2, y2, z2, voxel_width);
+    if (VoxelTraverser_is_end(&traverser))
+        return;
+    while (true)
+    {
+        VoxelTraverser_next(&traverser);
+        if (VoxelTraverser_is_end(&traverser))
+            break;
+        int32_t x, y, z;
+        VoxelTraverser_get_point(&traverser, &x, &y, &z);
+        callback(x, y, z, user_data);
+    }
+}
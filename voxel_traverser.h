@@ -0,0 +1,114 @@
+
+/// voxel_traverser.h
+/// Provides functions for traversing a line over a 3D grid of voxels, where the starting and ending points
+/// have sub-voxel coordinates.
+
+#ifndef VOXEL_TRAVERSER_H
+#define VOXEL_TRAVERSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// 3D version of LineTraverser. Instead of one clockwiseness, there is one for every pair of axes,
+/// each deciding which of the two axes reaches its next voxel boundary first.
+typedef struct
+{
+    int64_t clockwiseness_xy, clockwiseness_xz, clockwiseness_yz;
+    int64_t dx_clockwiseness_xy, dy_clockwiseness_xy;
+    int64_t dx_clockwiseness_xz, dz_clockwiseness_xz;
+    int64_t dy_clockwiseness_yz, dz_clockwiseness_yz;
+    int32_t x, y, z;
+    int32_t dx_x, dy_y, dz_z;
+    int32_t end_x, end_y, end_z;
+} VoxelTraverser;
+
+/// Initializes a VoxelTraverser for a given line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param z1 is the z coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param z2 is the z coordinate of the ending point of the line.
+/// @param voxel_width is the width of a voxel in the grid being traversed.
+/// @returns a VoxelTraverser which can be used to traverse all voxels which intersect the line.
+/// @remarks This uses the same rules as LineTraverser_init(), for every axis. If the line intersects only
+/// an edge or a corner of a voxel, that voxel will not be traversed. If the line lies exactly on the min side of
+/// a voxel on some axis (so it doesn't move along that axis), that voxel will be traversed.
+/// Only integer math is used, so the voxels traversed are the same on every compiler and platform.
+VoxelTraverser VoxelTraverser_init(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width);
+
+/// Tests if the current voxel in the traverser is the endpoint of the line.
+/// @param p_traverser is a pointer to the traverser to test.
+/// @returns true if this current voxel is the last one. False otherwise.
+/// @remarks See LineTraverser_is_end().
+bool VoxelTraverser_is_end(const VoxelTraverser *p_traverser);
+
+/// Gets the current voxel coordinate of a VoxelTraverser.
+/// @param p_traverser is a pointer to the traverser to get the coordinate of.
+/// @param out_x is a pointer to write the x coordinate to.
+/// @param out_y is a pointer to write the y coordinate to.
+/// @param out_z is a pointer to write the z coordinate to.
+void VoxelTraverser_get_point(const VoxelTraverser *p_traverser, int32_t *out_x, int32_t *out_y, int32_t *out_z);
+
+/// Updates a VoxelTraverser to the next voxel coordinate.
+/// @param p_traverser is a pointer to the traverser to update.
+/// @remarks Every axis whose next voxel boundary is crossed first is stepped, so if the line goes exactly
+/// through an edge or a corner, 2 or 3 axes are stepped at once.
+void VoxelTraverser_next(VoxelTraverser *p_traverser);
+
+/// Gets the voxel coordinates of the endpoints of a line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param z1 is the z coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param z2 is the z coordinate of the ending point of the line.
+/// @param voxel_width is the width of a voxel in the grid being traversed.
+/// @param out_x1 is a pointer to write the x coordinate which corresponds to x1 in voxel coordinates.
+/// @param out_y1 is a pointer to write the y coordinate which corresponds to y1 in voxel coordinates.
+/// @param out_z1 is a pointer to write the z coordinate which corresponds to z1 in voxel coordinates.
+/// @param out_x2 is a pointer to write the x coordinate which corresponds to x2 in voxel coordinates.
+/// @param out_y2 is a pointer to write the y coordinate which corresponds to y2 in voxel coordinates.
+/// @param out_z2 is a pointer to write the z coordinate which corresponds to z2 in voxel coordinates.
+/// @remarks See LineTraverser_get_endpoints().
+void VoxelTraverser_get_endpoints(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width, int32_t *out_x1, int32_t *out_y1, int32_t *out_z1,
+    int32_t *out_x2, int32_t *out_y2, int32_t *out_z2);
+
+/// User defined function which can be called during a line traversal.
+/// @param x is the x coordinate of current voxel that intersects the line.
+/// @param y is the y coordinate of current voxel that intersects the line.
+/// @param z is the z coordinate of current voxel that intersects the line.
+/// @param user_data is a pointer to user defined data.
+typedef void (*VoxelTraverserCallback)(int32_t x, int32_t y, int32_t z, void *user_data);
+
+/// Traverses all voxels that intersect a line.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param z1 is the z coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param z2 is the z coordinate of the ending point of the line.
+/// @param voxel_width is the width of a voxel in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every voxel on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks Both the starting and ending voxels are included. See VoxelTraverser_init() for the rules.
+void VoxelTraverser_traverse_include_endpoints(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width, VoxelTraverserCallback callback, void *user_data);
+
+/// Traverses all voxels that intersect a line, excluding the starting and ending voxels.
+/// @param x1 is the x coordinate of the starting point of the line.
+/// @param y1 is the y coordinate of the starting point of the line.
+/// @param z1 is the z coordinate of the starting point of the line.
+/// @param x2 is the x coordinate of the ending point of the line.
+/// @param y2 is the y coordinate of the ending point of the line.
+/// @param z2 is the z coordinate of the ending point of the line.
+/// @param voxel_width is the width of a voxel in the grid being traversed.
+/// @param callback is a user-defined function which will be called for every voxel on the line.
+/// @param user_data is a pointer to user data passed to callback().
+/// @remarks See LineTraverser_traverse_exclude_endpoints().
+void VoxelTraverser_traverse_exclude_endpoints(int32_t x1, int32_t y1, int32_t z1, int32_t x2, int32_t y2, int32_t z2,
+    int32_t voxel_width, VoxelTraverserCallback callback, void *user_data);
+
+#endif // VOXEL_TRAVERSER_H